@@ -4,7 +4,7 @@ import Mode3Page from '../../pages/mode3/mode3Page';
 import { vi } from 'vitest';
 import { loadWasmModule } from '../../pages/mode3/wasmLoader';
 import axios from '../../components/axiosWrapper';
-import { checkDoorCodeAsync, getBookHintsAsync, saveTimeTakenAsync } from '../../pages/mode3/mode3Page';
+import { checkDoorCodeAsync, getBookHintsAsync, saveTimeTakenAsync, postTelemetryAsync } from '../../pages/mode3/mode3Page';
 
 vi.mock('../../pages/mode3/wasmLoader', () => ({
     loadWasmModule: vi.fn().mockResolvedValue({
@@ -12,6 +12,7 @@ vi.mock('../../pages/mode3/wasmLoader', () => ({
         stop: vi.fn(),
         setHidden: vi.fn(),
         setFocused: vi.fn(),
+        flushTelemetry: vi.fn(),
         checkDoorCodeResponse: vi.fn(),
         setBookHints: vi.fn(),
         StringList: vi.fn().mockImplementation(() => ({
@@ -85,8 +86,15 @@ describe('Mode3Page', () => {
             </MemoryRouter>
         );
 
-        await saveTimeTakenAsync(120);
-        expect(axios.post).toHaveBeenCalledWith('/api/SaveTask3TimeTaken?seconds=120');
+        await saveTimeTakenAsync(120, 'SUwB');
+        expect(axios.post).toHaveBeenCalledWith('/api/SaveTask3TimeTaken?seconds=120', { inputLog: 'SUwB' });
+    });
+
+    test('postTelemetryAsync function', async () => {
+        axios.post.mockResolvedValue({});
+
+        await postTelemetryAsync({ scene: 'firstmap', hitches: 2 });
+        expect(axios.post).toHaveBeenCalledWith('/api/Task3Telemetry', expect.objectContaining({ scene: 'firstmap', hitches: 2 }));
     });
 
     test('checkDoorCode function', async () => {
@@ -96,7 +104,10 @@ describe('Mode3Page', () => {
         (window as any).getBookHints(3);
     });
     test('winGame function', async () => {
-        (window as any).winGame(42);
+        (window as any).winGame(42, 'SUwB');
+    });
+    test('reportTelemetry function', async () => {
+        (window as any).reportTelemetry({ scene: 'firstmap' });
     });
 
     test('useOnScreen hook', async () => {
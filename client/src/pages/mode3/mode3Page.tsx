@@ -97,15 +97,34 @@ const getBookHintsAsync = async (taskRef: React.MutableRefObject<number>, count:
         return [];
     }
 };
-const saveTimeTakenAsync = async (timeTaken: number) => {
+const saveTimeTakenAsync = async (timeTaken: number, inputLog: string) => {
     try {
-        await axios.post('/api/SaveTask3TimeTaken?seconds=' + timeTaken);
+        // the input log lets the server replay the run and check the time
+        await axios.post('/api/SaveTask3TimeTaken?seconds=' + timeTaken, { inputLog: inputLog });
     } catch (err) {
         console.error('Error posting task3 saveTimeTaken:', err);
     }
 };
 
-export { checkDoorCodeAsync, getBookHintsAsync, saveTimeTakenAsync };
+// frame pacing batch from the game, sent every 30 s of play with the hardware it ran on
+const postTelemetryAsync = async (batch: object) => {
+    const data = {
+        ...batch,
+        userAgent: navigator.userAgent,
+        cores: navigator.hardwareConcurrency,
+        // eslint-disable-next-line
+        memory: (navigator as any).deviceMemory,
+        pixelRatio: window.devicePixelRatio,
+        screen: screen.width + 'x' + screen.height,
+    };
+    try {
+        await axios.post('/api/Task3Telemetry', data);
+    } catch (err) {
+        console.error('Error posting task3 telemetry:', err);
+    }
+};
+
+export { checkDoorCodeAsync, getBookHintsAsync, saveTimeTakenAsync, postTelemetryAsync };
 
 const Mode3Page: React.FC = () => {
     const navigate = useNavigate();
@@ -142,8 +161,12 @@ const Mode3Page: React.FC = () => {
                 });
             };
             // eslint-disable-next-line
-            (window as any).winGame = (timeTaken: number) => {
-                saveTimeTakenAsync(Math.floor(timeTaken));
+            (window as any).winGame = (timeTaken: number, inputLog: string) => {
+                saveTimeTakenAsync(Math.floor(timeTaken), inputLog);
+            };
+            // eslint-disable-next-line
+            (window as any).reportTelemetry = (batch: object) => {
+                postTelemetryAsync(batch);
             };
 
             // try-catch is a must because emscripten_set_main_loop() throws to exit the function
@@ -154,6 +177,7 @@ const Mode3Page: React.FC = () => {
             }
         });
         return () => {
+            moduleRef.current?.flushTelemetry();
             moduleRef.current?.stop();
             // eslint-disable-next-line
             (moduleRef.current as any)['canvas'] = undefined;
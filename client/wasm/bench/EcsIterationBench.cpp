@@ -0,0 +1,123 @@
+// compares plain views against the owning groups declared in GameScene,
+// on firstmap copied many times over with some entity churn in between. every copied entity
+// gets all four components, this shows how the gap scales with size. the layout SceneBuilder
+// really builds is measured by the same cases in the browser game suite (GameBenchmarks.cpp).
+// build with -DWASMGAME_BENCHMARKS=ON and run: node wasmgame_bench.js [copies] [--json]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <entt/entt.hpp>
+#include <random>
+#include <vector>
+#include <wgleng/core/Components.h>
+
+#include "../src/game/util/Benchmark.h"
+#include "../src/scenes/firstmap.h"
+
+namespace {
+
+void Populate(entt::registry& registry, uint32_t copies) {
+	std::mt19937 rng{1234};
+	std::vector<entt::entity> created;
+	for (uint32_t copy = 0; copy < copies; copy++) {
+		for (uint32_t i = 0; i < firstmap_stateCount; i++) {
+			const auto entity = registry.create();
+			const float offset = static_cast<float>(copy) * 500.0f + static_cast<float>(i);
+			registry.emplace<TransformComponent>(entity, TransformComponent{.position = {offset, 0, 0}});
+			registry.emplace<MeshComponent>(entity, MeshComponent{});
+			registry.emplace<FlagComponent>(entity, FlagComponent{});
+			registry.emplace<RigidBodyComponent>(entity, RigidBodyComponent{});
+			created.push_back(entity);
+
+			// some entities without meshes, like the player, texts and triggers
+			if (i % 8 == 0) {
+				const auto extra = registry.create();
+				registry.emplace<TransformComponent>(extra, TransformComponent{});
+				registry.emplace<FlagComponent>(extra, FlagComponent{});
+			}
+		}
+	}
+
+	// churn: destroy and recreate a fifth, like picked up books and opened doors do over a session
+	std::shuffle(created.begin(), created.end(), rng);
+	const size_t churn = created.size() / 5;
+	for (size_t i = 0; i < churn; i++) registry.destroy(created[i]);
+	for (size_t i = 0; i < churn; i++) {
+		const auto entity = registry.create();
+		registry.emplace<RigidBodyComponent>(entity, RigidBodyComponent{});
+		registry.emplace<MeshComponent>(entity, MeshComponent{});
+		registry.emplace<FlagComponent>(entity, FlagComponent{});
+		registry.emplace<TransformComponent>(entity, TransformComponent{.position = {static_cast<float>(i), 1, 0}});
+	}
+}
+
+// roughly what the renderer reads per mesh
+float SumTransform(const TransformComponent& transform, const MeshComponent& mesh) {
+	return transform.position.x + transform.rotation.y + transform.scale.z + static_cast<float>(mesh.highlightId);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	uint32_t copies = 50;
+	bool json = false;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--json") == 0) json = true;
+		else copies = static_cast<uint32_t>(std::atoi(argv[i]));
+	}
+	constexpr int iterations = 200;
+
+	entt::registry viewRegistry;
+	Populate(viewRegistry, copies);
+
+	entt::registry groupRegistry;
+	groupRegistry.group<MeshComponent, TransformComponent>();
+	groupRegistry.group<RigidBodyComponent, FlagComponent>();
+	Populate(groupRegistry, copies);
+
+	Benchmark::Suite suite("ecs");
+	volatile float sink = 0;
+	const double meshView = suite.Run("mesh+transform view", iterations, [&] {
+		float sum = 0;
+		for (auto&& [entity, mesh, transform] : viewRegistry.view<MeshComponent, TransformComponent>().each()) {
+			sum += SumTransform(transform, mesh);
+		}
+		sink = sum;
+	}).medianNs;
+	const double meshGroup = suite.Run("mesh+transform group", iterations, [&] {
+		float sum = 0;
+		for (auto&& [entity, mesh, transform] : groupRegistry.group<MeshComponent, TransformComponent>().each()) {
+			sum += SumTransform(transform, mesh);
+		}
+		sink = sum;
+	}).medianNs;
+	const double bodyView = suite.Run("body+flag view", iterations, [&] {
+		uint32_t count = 0;
+		for (auto&& [entity, rbComp, flagComp] : viewRegistry.view<RigidBodyComponent, FlagComponent>().each()) {
+			count += (rbComp.body == nullptr) + (flagComp.flags & EntityFlags::PICKABLE ? 1 : 0);
+		}
+		sink = static_cast<float>(count);
+	}).medianNs;
+	const double bodyGroup = suite.Run("body+flag group", iterations, [&] {
+		uint32_t count = 0;
+		for (auto&& [entity, rbComp, flagComp] : groupRegistry.group<RigidBodyComponent, FlagComponent>().each()) {
+			count += (rbComp.body == nullptr) + (flagComp.flags & EntityFlags::PICKABLE ? 1 : 0);
+		}
+		sink = static_cast<float>(count);
+	}).medianNs;
+
+	// the gain the groups were declared for, kept with the results
+	suite.AddValue("mesh+transform group speedup", meshView / meshGroup);
+	suite.AddValue("body+flag group speedup", bodyView / bodyGroup);
+	if (json) {
+		std::fputs(suite.ToJson().c_str(), stdout);
+		return 0;
+	}
+	const size_t meshes = groupRegistry.group<MeshComponent, TransformComponent>().size();
+	std::printf("firstmap x%u, %zu mesh entities, median of %d runs\n", copies, meshes, iterations);
+	std::printf("mesh+transform  view %10.0f ns  group %10.0f ns  (x%.2f)\n", meshView, meshGroup, meshView / meshGroup);
+	std::printf("body+flag       view %10.0f ns  group %10.0f ns  (x%.2f)\n", bodyView, bodyGroup, bodyView / bodyGroup);
+	return 0;
+}
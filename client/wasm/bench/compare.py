@@ -0,0 +1,75 @@
+# Compares benchmark results against the checked-in baseline.
+# usage: python bench/compare.py bench/results/game.json [--threshold 0.10] [--update]
+# exits with 1 if any case got slower than the threshold allows, a suite has no baseline yet,
+# or an owning group case is slower than its view case from the same run.
+
+import argparse
+import json
+import os
+import sys
+
+dirname = os.path.dirname(__file__)
+
+parser = argparse.ArgumentParser()
+parser.add_argument('results', nargs='+', help='json written by a benchmark suite')
+parser.add_argument('--baseline', default=os.path.join(dirname, 'baseline.json'))
+parser.add_argument('--threshold', type=float, default=0.10, help='allowed median slowdown, 0.10 is 10%%')
+parser.add_argument('--update', action='store_true', help='write the results into the baseline instead')
+args = parser.parse_args()
+
+with open(args.baseline) as f:
+    baseline = json.load(f)
+
+regressed = False
+missing = False
+for path in args.results:
+    with open(path) as f:
+        results = json.load(f)
+    suite = results['suite']
+    cases = results['cases']
+
+    # before and after in the same run: an owning group has to beat the plain view it replaced
+    for name, case in cases.items():
+        if not name.endswith(' group') or name[:-len('group')] + 'view' not in cases:
+            continue
+        view_median = cases[name[:-len('group')] + 'view']['median_ns']
+        speedup = view_median / case['median_ns'] if case['median_ns'] > 0 else 0
+        status = ''
+        if speedup < 1:
+            status = '  GROUP SLOWER THAN VIEW'
+            regressed = True
+        print(f'{suite}: {name[:-len(" group")]} group x{speedup:.2f} over view{status}')
+
+    if args.update:
+        baseline[suite] = cases
+        print(f'{suite}: baseline updated with {len(cases)} cases')
+        continue
+
+    base_cases = baseline.get(suite, {})
+    if not base_cases:
+        print(f'{suite}: no baseline recorded, run with --update on the reference machine and commit bench/baseline.json')
+        missing = True
+        continue
+    print(f'{suite}:')
+    for name, case in cases.items():
+        median = case['median_ns']
+        if name not in base_cases:
+            print(f'  {name:32} {median:12.0f} ns  (new)')
+            continue
+        base_median = base_cases[name]['median_ns']
+        change = (median - base_median) / base_median if base_median > 0 else 0
+        status = ''
+        if change > args.threshold:
+            status = '  REGRESSION'
+            regressed = True
+        print(f'  {name:32} {median:12.0f} ns  {base_median:12.0f} ns  {change * 100:+6.1f}%{status}')
+    for name in base_cases:
+        if name not in cases:
+            print(f'  {name:32} missing from results')
+
+if args.update:
+    with open(args.baseline, 'w') as f:
+        json.dump(baseline, f, indent=2)
+        f.write('\n')
+
+sys.exit(1 if regressed or missing else 0)
@@ -0,0 +1,75 @@
+# Runs the browser benchmark suites in headless chrome, no window and no key presses needed.
+# usage: python bench/run_headless.py [--stress 4096] [--chrome path] [--timeout 900]
+# needs a release or debug module in interface/, slim modules have no benchmarks.
+# writes bench/results/game.json, or bench/results/stress.json with --stress, and exits with 1 if no results came back.
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import threading
+from http.server import HTTPServer, SimpleHTTPRequestHandler
+
+BENCH_RESULTS_PATH = 'bench/results'
+CHROME_NAMES = ['google-chrome', 'google-chrome-stable', 'chromium', 'chromium-browser', 'chrome']
+
+dirname = os.path.dirname(os.path.abspath(__file__))
+root = os.path.dirname(dirname)
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--stress', type=int, default=0, help='run the stress suite up to this many bookshelves instead of the game suite')
+parser.add_argument('--chrome', default=os.environ.get('CHROME'), help='chrome or chromium binary, searched on PATH by default')
+parser.add_argument('--timeout', type=float, default=900, help='seconds to wait for the results')
+parser.add_argument('--port', type=int, default=8001)
+args = parser.parse_args()
+
+chrome = args.chrome or next((path for path in map(shutil.which, CHROME_NAMES) if path), None)
+if not chrome:
+    sys.exit('no chrome found, pass --chrome or set CHROME')
+
+finished = threading.Event()
+failure = []
+
+class Handler(SimpleHTTPRequestHandler):
+    def __init__(self, *handler_args, **kwargs):
+        super().__init__(*handler_args, directory=root, **kwargs)
+
+    def log_message(self, format, *log_args):
+        pass
+
+    def do_POST(self):
+        body = self.rfile.read(int(self.headers['Content-Length'])).decode('utf-8')
+        path_parts = self.path.split('/')
+        if len(path_parts) > 2 and path_parts[1] == 'results':
+            os.makedirs(os.path.join(root, BENCH_RESULTS_PATH), exist_ok=True)
+            result_path = os.path.join(root, f'{BENCH_RESULTS_PATH}/{path_parts[2]}.json')
+            with open(result_path, 'w') as f:
+                f.write(body)
+            print(f'wrote {result_path}')
+        else:
+            failure.append(body)
+        self.send_response(200)
+        self.end_headers()
+        finished.set()
+
+httpd = HTTPServer(('localhost', args.port), Handler)
+threading.Thread(target=httpd.serve_forever, daemon=True).start()
+
+query = f'?stress={args.stress}' if args.stress > 0 else ''
+with tempfile.TemporaryDirectory() as profile:
+    # swiftshader gives headless chrome webgl without a gpu, the numbers are cpu side only anyway
+    browser = subprocess.Popen([chrome, '--headless=new', '--no-first-run', '--no-default-browser-check',
+        f'--user-data-dir={profile}', '--use-angle=swiftshader', '--enable-unsafe-swiftshader',
+        '--disable-background-timer-throttling', f'http://localhost:{args.port}/bench/headless.html{query}'],
+        stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    done = finished.wait(args.timeout)
+    browser.terminate()
+    browser.wait()
+httpd.shutdown()
+
+if not done:
+    sys.exit(f'no results after {args.timeout:.0f} seconds')
+if failure:
+    sys.exit(f'module failed: {failure[0]}')
@@ -0,0 +1,129 @@
+# Reports how much of a wasm module's code belongs to the debug tooling linked in from the engine.
+# usage: python bench/wasm_size.py interface/wasmInterface.wasm [other.wasm]
+# the module needs function names, configure with -DWASMGAME_SIZE_REPORT=ON. names do not change the code.
+# with two modules the second column is the difference to the first.
+
+import argparse
+import re
+import sys
+
+GROUPS = {
+    'imgui': re.compile(r'ImGui|^Im[A-Z]|imgui'),
+    'debug draw': re.compile(r'DebugDraw'),
+    'editor': re.compile(r'Editor'),
+}
+
+parser = argparse.ArgumentParser()
+parser.add_argument('modules', nargs='+', help='wasm files, at most two')
+args = parser.parse_args()
+if len(args.modules) > 2:
+    parser.error('at most two modules')
+
+
+class Reader:
+    def __init__(self, data, pos=0, end=None):
+        self.data = data
+        self.pos = pos
+        self.end = len(data) if end is None else end
+
+    def byte(self):
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def leb(self):
+        value = 0
+        shift = 0
+        while True:
+            b = self.byte()
+            value |= (b & 0x7f) << shift
+            shift += 7
+            if b & 0x80 == 0:
+                return value
+
+    def name(self):
+        length = self.leb()
+        value = self.data[self.pos:self.pos + length].decode('utf-8', 'replace')
+        self.pos += length
+        return value
+
+    def limits(self):
+        flags = self.byte()
+        self.leb()
+        if flags & 1:
+            self.leb()
+
+
+def read_module(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:4] != b'\0asm':
+        sys.exit(f'{path}: not a wasm module')
+
+    imported = 0
+    bodies = []
+    names = {}
+    reader = Reader(data, 8)
+    while reader.pos < len(data):
+        section = reader.byte()
+        size = reader.leb()
+        end = reader.pos + size
+        content = Reader(data, reader.pos, end)
+        if section == 2:
+            for _ in range(content.leb()):
+                content.name()
+                content.name()
+                kind = content.byte()
+                if kind == 0:
+                    content.leb()
+                    imported += 1
+                elif kind == 1:
+                    content.byte()
+                    content.limits()
+                elif kind == 2:
+                    content.limits()
+                elif kind == 3:
+                    content.byte()
+                    content.byte()
+                elif kind == 4:
+                    content.byte()
+                    content.leb()
+        elif section == 10:
+            for _ in range(content.leb()):
+                body = content.leb()
+                bodies.append(body)
+                content.pos += body
+        elif section == 0 and content.name() == 'name':
+            while content.pos < end:
+                subsection = content.byte()
+                subsize = content.leb()
+                subend = content.pos + subsize
+                if subsection == 1:
+                    for _ in range(content.leb()):
+                        index = content.leb()
+                        names[index] = content.name()
+                content.pos = subend
+        reader.pos = end
+
+    sizes = {'total': len(data), 'code': sum(bodies)}
+    if not names:
+        print(f'{path}: no function names, configure with -DWASMGAME_SIZE_REPORT=ON to split the code', file=sys.stderr)
+        return sizes
+    for group in GROUPS:
+        sizes[group] = 0
+    for i, body in enumerate(bodies):
+        name = names.get(imported + i, '')
+        for group, pattern in GROUPS.items():
+            if pattern.search(name):
+                sizes[group] += body
+                break
+    return sizes
+
+
+modules = [read_module(path) for path in args.modules]
+print(f'{"":12}' + ''.join(f'{path[-32:]:>34}' for path in args.modules) + ('  difference' if len(modules) == 2 else ''))
+for key in ['total', 'code', *GROUPS]:
+    row = f'{key:12}' + ''.join(f'{sizes[key]:>34,}' if key in sizes else f'{"-":>34}' for sizes in modules)
+    if len(modules) == 2 and all(key in sizes for sizes in modules):
+        row += f'  {modules[1][key] - modules[0][key]:+,}'
+    print(row)
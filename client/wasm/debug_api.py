@@ -1,10 +1,14 @@
 # Hosts shaders on localhost, to allow hot-reloading them from wasm.
-# Now it saves scenes too.
+# Now it saves scenes and benchmark results too.
 
 SHADER_PATH = 'dependencies/wgleng/src/wgleng/rendering/shaders'
 SCENES_PATH = 'src/scenes'
+BENCH_RESULTS_PATH = 'bench/results'
 
+import difflib
+import json
 import os
+import time
 from http.server import HTTPServer, SimpleHTTPRequestHandler
 from urllib.parse import urlparse
 
@@ -23,6 +27,27 @@ def new_path(parsed_path):
         path_parts.insert(0, SCENES_PATH)
     return '/'.join(path_parts)
 
+def scene_rows(text):
+    return [line.strip() for line in text.splitlines() if line.strip().startswith('{')]
+
+# row level diff of a saved scene, unchanged scenes are not written again.
+# added and modified are indices into the new state list, removed into the old one
+def diff_scene(old_text, new_text):
+    added, removed, modified = [], [], []
+    old_rows, new_rows = scene_rows(old_text), scene_rows(new_text)
+    matcher = difflib.SequenceMatcher(a=old_rows, b=new_rows, autojunk=False)
+    for tag, a_start, a_end, b_start, b_end in matcher.get_opcodes():
+        if tag == 'replace':
+            paired = min(a_end - a_start, b_end - b_start)
+            modified += range(b_start, b_start + paired)
+            added += range(b_start + paired, b_end)
+            removed += range(a_start + paired, a_end)
+        elif tag == 'insert':
+            added += range(b_start, b_end)
+        elif tag == 'delete':
+            removed += range(a_start, a_end)
+    return {'states': len(new_rows), 'added': added, 'removed': removed, 'modified': modified}
+
 class CORSRequestHandler(SimpleHTTPRequestHandler):
     def end_headers(self):
         self.send_header('Access-Control-Allow-Origin', '*')
@@ -51,14 +76,38 @@ class CORSRequestHandler(SimpleHTTPRequestHandler):
         # Parse the URL and extract the name
         parsed_path = urlparse(self.path)
         path_parts = parsed_path.path.split('/')
-        if len(path_parts) > 2 and path_parts[1] == 'SaveScene':
-            scene_name = path_parts[2]
+        file_data = post_body.decode('utf-8')
+        if len(path_parts) > 2 and path_parts[1] == 'SaveBench':
+            os.makedirs(os.path.join(dirname, BENCH_RESULTS_PATH), exist_ok=True)
+            with open(os.path.join(dirname, f'{BENCH_RESULTS_PATH}/{path_parts[2]}.json'), 'w') as f:
+                f.write(file_data)
         else:
-            scene_name = 'Unknown'
+            if len(path_parts) > 2 and path_parts[1] == 'SaveScene':
+                scene_name = path_parts[2]
+            else:
+                scene_name = 'Unknown'
 
-        file_data = post_body.decode('utf-8')
-        with open(os.path.join(dirname, f'{SCENES_PATH}/{scene_name}.h'), 'w') as f:
-            f.write(file_data)
+            start = time.perf_counter()
+            scene_path = os.path.join(dirname, f'{SCENES_PATH}/{scene_name}.h')
+            old_data = ''
+            if os.path.exists(scene_path):
+                with open(scene_path) as f:
+                    old_data = f.read()
+            diff = diff_scene(old_data, file_data)
+            # an unchanged file keeps its timestamp, so nothing rebuilds
+            if old_data != file_data:
+                with open(scene_path, 'w') as f:
+                    f.write(file_data)
+            diff['ms'] = round((time.perf_counter() - start) * 1000, 2)
+            print(f'scene {scene_name}: +{len(diff["added"])} -{len(diff["removed"])} ~{len(diff["modified"])} of {diff["states"]} rows, {diff["ms"]} ms')
+            new_rows = scene_rows(file_data)
+            for index in diff['modified']:
+                print(f'  ~{index}: {new_rows[index]}')
+
+            self.send_response(200)
+            self.end_headers()
+            self.wfile.write(json.dumps(diff).encode('utf-8'))
+            return
 
         self.send_response(200)
         self.end_headers()
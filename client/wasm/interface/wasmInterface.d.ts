@@ -41,6 +41,22 @@ interface EmbindModule {
   stop(): void;
   setFocused(_0: boolean): void;
   setHidden(_0: boolean): void;
+  runLevelSetHidden(_0: boolean): void;
+  runLevelSetFocused(_0: boolean): void;
+  restart(): void;
+  getMemoryStats(): any;
+  getAllocationReport(): string;
+  setRenderRecording(_0: boolean): void;
+  setRenderQueueEnabled(_0: boolean): void;
+  getRenderSummary(): string;
+  getInputLatency(): number;
+  runBenchmarks(): void;
+  runStressTest(_0: number): void;
+  getBenchmarkResults(): string;
+  flushTelemetry(): void;
+  replayInputLog(_0: EmbindString, _1: number): void;
+  getReplayResult(): string;
+  loadLevel(_0: EmbindString): boolean;
 }
 
 export type MainModule = WasmModule & typeof RuntimeExports & EmbindModule;
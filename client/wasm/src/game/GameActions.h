@@ -7,6 +7,7 @@ enum class Action {
 	Throw,
 	Interact,
 	WinGame,
+	OpenSecretDoor,
 	ActionCount,
 };
 
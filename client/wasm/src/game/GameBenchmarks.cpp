@@ -0,0 +1,235 @@
+#include "GameBenchmarks.h"
+
+#include <emscripten/bind.h>
+#include <emscripten/emscripten.h>
+#include <format>
+#include <string>
+#include <vector>
+#include <wgleng/core/Components.h>
+
+#include "../scenes/firstmap.h"
+#include "GameScene.h"
+#include "ModelInit.h"
+#include "StressScene.h"
+#include "scripts/MainScript.h"
+#include "util/Benchmark.h"
+#include "util/MemoryStats.h"
+#include "util/TextCache.h"
+
+namespace {
+#ifdef SHADER_HOT_RELOAD
+	constexpr bool SAVE_TO_DEBUG_API = true;
+#else
+	constexpr bool SAVE_TO_DEBUG_API = false;
+#endif
+
+	bool s_requested = false;
+	uint32_t s_stressMaxBookshelves = 0;
+	std::string s_lastResults;
+
+	// everything SceneBuilder::Load created, the player stays
+	void DestroySceneEntities(GameScene& scene) {
+		std::vector<entt::entity> entities;
+		for (const auto entity : scene.registry.view<TransformComponent>(entt::exclude<PlayerComponent>)) {
+			entities.push_back(entity);
+		}
+		if (scene.player.objectCarry.GetCarriedEntity() != entt::null) scene.player.objectCarry.DropCarriedEntity();
+		scene.registry.destroy(entities.begin(), entities.end());
+	}
+
+	// the component of every entity that has one, in entity order like a load creates them
+	template<typename Component>
+	void CopyComponents(const entt::registry& from, entt::registry& to) {
+		for (const auto [entity] : to.storage<entt::entity>().each()) {
+			if (const auto* component = from.try_get<Component>(entity)) to.emplace<Component>(entity, *component);
+		}
+	}
+
+	// the node runner's view/group pairs on the layout SceneBuilder really builds for firstmap,
+	// player, texts and bodies without meshes included. the view side reads a plain copy of it
+	void RunIterationCases(Benchmark::Suite& suite, GameScene& scene) {
+		entt::registry plain;
+		for (const auto [entity] : scene.registry.storage<entt::entity>().each()) plain.create(entity);
+		CopyComponents<TransformComponent>(scene.registry, plain);
+		CopyComponents<MeshComponent>(scene.registry, plain);
+		CopyComponents<FlagComponent>(scene.registry, plain);
+		// bodies stay with the scene, the loops only read the pointer
+		for (const auto entity : scene.registry.view<RigidBodyComponent>()) plain.emplace<RigidBodyComponent>(entity);
+
+		volatile float sink = 0;
+		const auto sumMeshes = [&](auto&& iterable) {
+			float sum = 0;
+			for (auto&& [entity, mesh, transform] : iterable.each()) {
+				sum += transform.position.x + transform.rotation.y + transform.scale.z + static_cast<float>(mesh.highlightId);
+			}
+			sink = sum;
+		};
+		const auto countBodies = [&](auto&& iterable) {
+			uint32_t count = 0;
+			for (auto&& [entity, rbComp, flagComp] : iterable.each()) {
+				count += (rbComp.body == nullptr) + (flagComp.flags & EntityFlags::PICKABLE ? 1 : 0);
+			}
+			sink = static_cast<float>(count);
+		};
+		const double meshView = suite.Run("mesh+transform view", 2000, [&] {
+			sumMeshes(plain.view<MeshComponent, TransformComponent>());
+		}).medianNs;
+		const double meshGroup = suite.Run("mesh+transform group", 2000, [&] {
+			sumMeshes(scene.MeshGroup());
+		}).medianNs;
+		const double bodyView = suite.Run("body+flag view", 2000, [&] {
+			countBodies(plain.view<RigidBodyComponent, FlagComponent>());
+		}).medianNs;
+		const double bodyGroup = suite.Run("body+flag group", 2000, [&] {
+			countBodies(scene.BodyGroup());
+		}).medianNs;
+
+		suite.AddValue("firstmap entities", static_cast<double>(plain.storage<entt::entity>().size()));
+		suite.AddValue("firstmap mesh entities", static_cast<double>(scene.MeshGroup().size()));
+		suite.AddValue("firstmap body entities", static_cast<double>(scene.BodyGroup().size()));
+		suite.AddValue("mesh+transform group speedup", meshView / meshGroup);
+		suite.AddValue("body+flag group speedup", bodyView / bodyGroup);
+	}
+
+	void RunSuite(Benchmark::Suite& suite, TimeDuration dt) {
+		GameScene scene;
+		scene.SetOffline(true);
+
+		// the same uploads as the first LoadModels, into the meshes the live scene already has
+		suite.Run("LoadModels", 10, [&] {
+			ReloadModels();
+		});
+		suite.Run("SceneBuilder::Load firstmap", 20, [&] {
+			DestroySceneEntities(scene);
+		}, [&] {
+			scene.GetSceneBuilder().Load(firstmap_stateCount, firstmap_states);
+		});
+		RunIterationCases(suite, scene);
+
+		// same ray HeldObjectScript casts every frame
+		suite.Run("pickup raycast", 2000, [&] {
+			const auto& camera = scene.player.GetCamera();
+			PhysicsQueries::RayHit hit;
+			scene.physicsQueries.RaycastClosest({camera->position, camera->position + camera->GetFront() * 50.0f},
+				EntityFlags::PICKABLE, hit);
+		});
+
+		suite.Run("MainScript::Update", 200, [&] {
+			scene.mainScript->Update(dt);
+		});
+		suite.Run("MainScript::Draw", 200, [&] {
+			scene.mainScript->Draw();
+		});
+
+		entt::entity pickable = entt::null;
+		for (auto&& [entity, rbComp, flagComp] : scene.BodyGroup().each()) {
+			if (!(flagComp.flags & EntityFlags::PICKABLE) || !rbComp.body) continue;
+			pickable = entity;
+			break;
+		}
+		if (pickable != entt::null) {
+			scene.player.objectCarry.SetCarriedEntity(pickable);
+			suite.Run("ObjectCarry::Update", 2000, [&] {
+				const auto& camera = scene.player.GetCamera();
+				scene.player.objectCarry.Update(camera->position, camera->GetFront(), scene.physicsSync);
+			});
+			scene.player.objectCarry.DropCarriedEntity();
+		}
+
+		suite.Run("control hint CreateText", 200, [&] {
+			Text::CreateText("arial-big", "$<1>F - pickup");
+		});
+		TextCache cache;
+		suite.Run("control hint TextCache", 2000, [&] {
+			cache.Get("arial-big", "$<1>F - pickup");
+			cache.EndFrame();
+		});
+	}
+
+	// the scene is never rendered, this is the cpu side of a frame only
+	void RunStressSuite(Benchmark::Suite& suite, uint32_t maxBookshelves) {
+		constexpr uint32_t WARMUP_FRAMES = 30;
+		constexpr uint32_t FRAMES = 120;
+
+		GameScene scene;
+		scene.SetOffline(true);
+		std::vector<double> frameSamples, physicsSamples;
+		for (uint32_t shelves = 64; shelves <= maxBookshelves; shelves *= 2) {
+			DestroySceneEntities(scene);
+			const auto states = GenerateStressScene({.bookshelves = shelves, .books = shelves, .candles = shelves / 4});
+			{
+				MemoryTagScope scope(MemoryTag::Ecs);
+				scene.GetSceneBuilder().Load(static_cast<uint32_t>(states.size()), states.data());
+			}
+			// let the books settle on the tables. every sample is exactly one step, the live dt would
+			// make it 0, 1 or 2 depending on the clock
+			for (uint32_t i = 0; i < WARMUP_FRAMES; i++) scene.StepFrame();
+
+			frameSamples.clear();
+			physicsSamples.clear();
+			for (uint32_t i = 0; i < FRAMES; i++) {
+				const TimePoint start;
+				scene.StepFrame();
+				frameSamples.push_back((TimePoint() - start).fMilli() * 1e6);
+				physicsSamples.push_back(scene.GetPhysicsStepMs() * 1e6);
+			}
+
+			suite.AddSamples(std::format("frame shelves={}", shelves), frameSamples);
+			suite.AddSamples(std::format("physics shelves={}", shelves), physicsSamples);
+			// sizes and memory next to the times, compare.py only checks the times
+			suite.AddValue(std::format("states shelves={}", shelves), static_cast<double>(states.size()));
+			suite.AddValue(std::format("entities shelves={}", shelves), static_cast<double>(scene.registry.storage<entt::entity>().size()));
+			suite.AddValue(std::format("heap MB shelves={}", shelves), MemoryStats::GetHeapStats().usedBytes / 1048576.0);
+			suite.AddValue(std::format("physics MB shelves={}", shelves), MemoryStats::GetTagStats(MemoryTag::Physics).currentBytes / 1048576.0);
+			suite.AddValue(std::format("ecs MB shelves={}", shelves), MemoryStats::GetTagStats(MemoryTag::Ecs).currentBytes / 1048576.0);
+		}
+	}
+
+	void Publish(const Benchmark::Suite& suite, const char* name) {
+		suite.Print();
+		s_lastResults = suite.ToJson();
+		// the headless runner's page takes the results, otherwise debug builds save them through debug_api.py
+		EM_ASM({
+			if (typeof window['reportBenchmark'] === 'function') {
+				window['reportBenchmark'](UTF8ToString($0), UTF8ToString($1));
+			} else if ($2) {
+				fetch('http://localhost:8000/SaveBench/' + UTF8ToString($0), {method: 'POST', body: UTF8ToString($1)})
+					.catch((err) => console.error('could not save benchmark results', err));
+			}
+		}, name, s_lastResults.c_str(), SAVE_TO_DEBUG_API);
+	}
+}
+
+void RequestBenchmarks() {
+	s_requested = true;
+}
+void RequestStressTest(uint32_t maxBookshelves) {
+	s_stressMaxBookshelves = maxBookshelves;
+}
+
+void RunPendingBenchmarks(TimeDuration dt) {
+	if (!s_requested && s_stressMaxBookshelves == 0) return;
+
+	if (s_requested) {
+		Benchmark::Suite suite("game");
+		RunSuite(suite, dt);
+		Publish(suite, "game");
+	}
+	if (s_stressMaxBookshelves > 0) {
+		Benchmark::Suite suite("stress");
+		RunStressSuite(suite, s_stressMaxBookshelves);
+		Publish(suite, "stress");
+	}
+	s_requested = false;
+	s_stressMaxBookshelves = 0;
+}
+
+std::string getBenchmarkResults() {
+	return s_lastResults;
+}
+
+EMSCRIPTEN_BINDINGS(game_benchmarks) {
+	emscripten::function("runBenchmarks", &RequestBenchmarks);
+	emscripten::function("runStressTest", &RequestStressTest);
+	emscripten::function("getBenchmarkResults", &getBenchmarkResults);
+}
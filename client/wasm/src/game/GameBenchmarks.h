@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+#include <wgleng/util/Timer.h>
+
+// game hot path benchmarks, run in the browser on a scratch scene with the real engine.
+// trigger with CTRL+B, runBenchmarks() from js or bench/run_headless.py. results go to the
+// console and to the page's reportBenchmark, or in debug builds to debug_api.py, which
+// write bench/results/game.json.
+void RequestBenchmarks();
+// loads generated scenes of growing size (64 bookshelves, doubling up to maxBookshelves) and
+// times frames of exactly one fixed step and the physics step in them, with memory as values, results in bench/results/stress.json
+void RequestStressTest(uint32_t maxBookshelves);
+// runs requested benchmarks on scratch scenes, the live scene is left alone
+void RunPendingBenchmarks(TimeDuration dt);
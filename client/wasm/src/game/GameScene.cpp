@@ -1,46 +1,137 @@
 #include "GameScene.h"
 
+#include <algorithm>
+#include <limits>
 #include <wgleng/core/Components.h>
 #include <wgleng/io/Input.h>
 
-#include "../scenes/firstmap.h"
 #include "ModelInit.h"
+#include "RunLevel.h"
+#include "Telemetry.h"
 #include "scripts/MainScript.h"
+#include "util/MemoryStats.h"
 #include "wgleng/util/Metrics.h"
 
-GameScene::GameScene()
-	: player(registry, m_physicsWorld, {0, 5, 0}) {
+namespace {
+	constexpr auto MAX_FRAME_TIME = 100ms;
+	// physics and scripts always advance by this, so a log replays to the same result
+	constexpr auto FIXED_STEP = std::chrono::nanoseconds(1'000'000'000 / InputLog::STEP_HZ);
+	constexpr float FIXED_STEP_MS = 1000.0f / InputLog::STEP_HZ;
+
+	// states loaded between budget checks, a state is one entity and maybe its collider
+	constexpr size_t LOAD_CHUNK = 8;
+}
+
+GameScene::GameScene(const Level& level, LoadMode mode)
+	: physicsSync(registry), physicsQueries(registry), renderQueue(registry), player(registry, m_physicsWorld, {0, 5, 0}),
+	m_level(level) {
 	SetCamera(player.GetCamera());
 	sunlightDir = glm::normalize(glm::vec3{1, 2, 1});
 
+	// declare hot groups before loading, so the scene is created packed
+	MeshGroup();
+	BodyGroup();
+
 	LoadModels(m_sceneBuilder);
+	if (mode == LoadMode::Staged) return;
+
+	LoadStep(std::numeric_limits<float>::infinity());
+	Activate();
+}
 
+bool GameScene::LoadStep(float budgetMs) {
+	MemoryTagScope scope(MemoryTag::Ecs);
 #ifdef SHADER_HOT_RELOAD
-	m_sceneBuilder.Load(firstmap_stateCount, firstmap_states, true);
+	// the editor saves the builder's state list, it has to come from a single load
+	if (!IsLoaded()) {
+		m_sceneBuilder.Load(static_cast<uint32_t>(m_level.states.size()), m_level.states.data(), true);
+		m_loadedStates = m_level.states.size();
+	}
+	return true;
 #else
-	m_sceneBuilder.Load(firstmap_stateCount, firstmap_states);
+	const TimePoint start;
+	while (!IsLoaded() && (TimePoint() - start).fMilli() < budgetMs) {
+		const size_t count = std::min(LOAD_CHUNK, m_level.states.size() - m_loadedStates);
+		m_sceneBuilder.Load(static_cast<uint32_t>(count), m_level.states.data() + m_loadedStates);
+		m_loadedStates += count;
+	}
+	return IsLoaded();
 #endif
+}
 
+void GameScene::Activate() {
+	if (mainScript) return;
 	mainScript = new MainScript(*this);
-
-	keyMapper.AddMapping().PressKey(SDL_SCANCODE_F).Then([&] {
-		actions.Trigger(Action::PickUp);
-	});
-	keyMapper.AddMapping().PressKey(SDL_SCANCODE_Q).Then([&] {
-		actions.Trigger(Action::Throw);
-	});
-	keyMapper.AddMapping().PressKey(SDL_SCANCODE_E).Then([&] {
-		actions.Trigger(Action::Interact);
-	});
+	m_inputLog.SetMouseSensitivity(player.mouseSensitivity);
 
 	m_sceneBuilder.Play();
+	m_snapshot.Capture(*this);
 }
 
 GameScene::~GameScene() {
 	delete mainScript;
 }
 
+bool GameScene::Restart() {
+	// scripts read the play time while restarting
+	m_step = 0;
+	m_stepBacklogMs = 0;
+	m_lastKeys = 0;
+	m_inputLog.Clear();
+	m_inputLog.SetMouseSensitivity(player.mouseSensitivity);
+	m_recording = true;
+	m_result = {};
+	if (!m_snapshot.Restore(*this)) return false;
+	// bodies were put back without a step
+	physicsQueries.Refresh();
+	return true;
+}
+
+GameScene::RunResult GameScene::Replay(const InputLog& log) {
+	if (!Restart()) return {};
+	m_recording = false;
+	m_replaying = true;
+	const float sensitivity = player.mouseSensitivity;
+	player.mouseSensitivity = log.GetMouseSensitivity();
+
+	const auto events = log.GetEvents();
+	size_t nextEvent = 0;
+	for (uint32_t i = 0; i < log.GetStepCount() && !m_result.won; i++) {
+		while (nextEvent < events.size() && events[nextEvent].step == i) {
+			ExternalEvent(events[nextEvent++].type);
+		}
+		const InputFrame& input = log.GetFrame(i);
+		player.ApplyLook(input.lookX, input.lookY);
+		Step(input);
+	}
+	if (!m_result.won) m_result.steps = m_step;
+
+	player.mouseSensitivity = sensitivity;
+	m_replaying = false;
+	return m_result;
+}
+
+void GameScene::ExternalEvent(InputEvent event) {
+	if (m_recording) m_inputLog.PushEvent(event);
+	switch (event) {
+	case InputEvent::DoorOpened: actions.Trigger(Action::OpenSecretDoor); break;
+	default: break;
+	}
+}
+
+bool GameScene::FinishRun(int32_t seconds) {
+	m_result = {true, m_step, seconds};
+	m_inputLog.SetWinStep(m_step);
+	m_recording = false;
+	return !m_replaying;
+}
+
 void GameScene::Update(TimeDuration dt) {
+	// nobody is looking, no physics, scripts or timers
+	if (RunLevels::Get() == RunLevel::Suspended) return;
+	// the first frame after a pause or a hitch must not catch up
+	if (dt > MAX_FRAME_TIME) dt = MAX_FRAME_TIME;
+
 	// "garbage collector"
 	static TimePoint lastPhysicsUpdate;
 	const TimePoint now;
@@ -51,24 +142,39 @@ void GameScene::Update(TimeDuration dt) {
 
 	// scene builder
 #ifdef SHADER_HOT_RELOAD
+	m_editTimer.Begin();
 	m_sceneBuilder.Update();
+	m_editTimer.End();
+	if (!m_sceneBuilder.IsPlaying()) {
+		m_editTimer.DrawOverlay();
+		// edits made in between would not replay
+		m_recording = false;
+	}
 	if (Input::JustPressed(SDL_SCANCODE_L)) {
 		m_sceneBuilder.Play();
 		if (m_sceneBuilder.IsPlaying()) {
-			player = Player(registry, m_physicsWorld, {0, 5, 0});
-			SetCamera(player.GetCamera());
+			// back to the spawn, then play the edited scene from here on restarts
+			m_snapshot.RestorePlayer(*this);
+			m_snapshot.Capture(*this);
+			physicsQueries.Refresh();
 		}
 	}
 #endif
 
 	// player movement
 	player.fly = !m_sceneBuilder.IsPlaying();
-	player.Update(dt.fMilli());
+	player.PollKeys();
 
 	// dont update if scene is not playing
-	if (!m_sceneBuilder.IsPlaying()) return;
+	if (!m_sceneBuilder.IsPlaying()) {
+		player.Update(dt.fMilli(), player.TakeInput());
+		player.ApplyMouseLook();
+		return;
+	}
 
-	keyMapper.Update();
+	const TimePoint updateStart;
+	m_physicsFrameMs = 0;
+	m_scriptsFrameMs = 0;
 
 	// scene metrics
 	if (Metrics::IsEnabled(Metric::ENTITY_COUNT)) {
@@ -76,14 +182,80 @@ void GameScene::Update(TimeDuration dt) {
 			static_cast<uint64_t>(registry.storage<entt::entity>().size()));
 	}
 
+	// fixed steps, any leftover time carries over to the next frame
+	m_stepBacklogMs += dt.fMilli();
+	while (m_stepBacklogMs >= FIXED_STEP_MS) {
+		m_stepBacklogMs -= FIXED_STEP_MS;
+		const InputFrame input = player.TakeInput();
+		if (m_recording) m_inputLog.Push(input);
+		Step(input);
+	}
+	DrawFrame();
+
+	Telemetry::Record(Telemetry::Timing::Update, (TimePoint() - updateStart).fMilli());
+	Telemetry::Record(Telemetry::Timing::Physics, m_physicsFrameMs);
+	Telemetry::Record(Telemetry::Timing::Scripts, m_scriptsFrameMs);
+}
+
+void GameScene::StepFrame() {
+	m_physicsFrameMs = 0;
+	m_scriptsFrameMs = 0;
+	const InputFrame input = player.TakeInput();
+	if (m_recording) m_inputLog.Push(input);
+	Step(input);
+	DrawFrame();
+}
+
+void GameScene::DrawFrame() {
+	// the frame is drawn between the last two steps, what the steps left over is the way there
+	player.InterpolateCamera(m_stepBacklogMs / FIXED_STEP_MS);
+	// late latch, look direction from all input up to now regardless of physics and script time
+	player.ApplyMouseLook();
+
+	// texts and highlights every frame, a frame without a step still shows them
+	{
+		MemoryTagScope scope(MemoryTag::Scripts);
+		mainScript->Draw();
+	}
+	// group meshes by state for the renderer, after scripts set highlights
+	renderQueue.Update();
+}
+
+void GameScene::Step(const InputFrame& input) {
+	// counted first, a win anywhere in this step is at the step count of the log, which already holds this frame
+	m_step++;
+	// the simulation sees step positions only, a replay draws no frames in between
+	player.SnapCameraToStep();
+	player.Update(FIXED_STEP_MS, input);
+
+	// actions fire on the step their key goes down
+	const uint16_t pressed = input.keys & ~m_lastKeys;
+	m_lastKeys = input.keys;
+	if (pressed & InputFrame::PICKUP) actions.Trigger(Action::PickUp);
+	if (pressed & InputFrame::THROW) actions.Trigger(Action::Throw);
+	if (pressed & InputFrame::INTERACT) actions.Trigger(Action::Interact);
+
 	// physics
 	Metrics::MeasureDurationStart(Metric::PHYICS);
-	m_physicsWorld.Update(dt);
-	player.UpdateCameraAfterPhysics();
+	{
+		MemoryTagScope scope(MemoryTag::Physics);
+		const TimePoint physicsStart;
+		physicsSync.BeginStep();
+		m_physicsWorld.Update(FIXED_STEP);
+		player.UpdateCameraAfterPhysics(physicsSync);
+		physicsQueries.Update(physicsSync);
+		m_physicsStepMs = (TimePoint() - physicsStart).fMilli();
+		m_physicsFrameMs += m_physicsStepMs;
+	}
 	Metrics::MeasureDurationStop(Metric::PHYICS);
 
 	// run scripts
 	Metrics::MeasureDurationStart(Metric::SCRIPTS);
-	mainScript->Update(dt);
+	{
+		MemoryTagScope scope(MemoryTag::Scripts);
+		const TimePoint scriptsStart;
+		mainScript->Update(FIXED_STEP);
+		m_scriptsFrameMs += (TimePoint() - scriptsStart).fMilli();
+	}
 	Metrics::MeasureDurationStop(Metric::SCRIPTS);
 }
\ No newline at end of file
@@ -2,18 +2,40 @@
 
 #include <functional>
 #include <string_view>
-#include <wgleng/core/KeyMapper.h>
+#include <wgleng/core/Components.h>
 #include <wgleng/core/Scene.h>
 #include <wgleng/util/Timer.h>
 
 #include "GameActions.h"
+#include "Levels.h"
 #include "Player.h"
+#include "SceneSnapshot.h"
+#include "systems/PhysicsQueries.h"
+#include "systems/PhysicsSync.h"
+#include "systems/RenderQueue.h"
+#include "util/InputLog.h"
+#ifdef SHADER_HOT_RELOAD
+#include "util/SceneEditTimer.h"
+#endif
 
 class MainScript;
 
 class GameScene final : public Scene {
 public:
-	GameScene();
+	struct RunResult {
+		bool won = false;
+		uint32_t steps = 0;
+		int32_t seconds = -1;
+	};
+
+	enum class LoadMode : uint8_t {
+		// loads the level and starts playing in the constructor
+		Immediate,
+		// LoadStep builds the level over several frames, Activate starts it
+		Staged,
+	};
+
+	explicit GameScene(const Level& level = Levels::GetFirst(), LoadMode mode = LoadMode::Immediate);
 	~GameScene() override;
 	GameScene(const GameScene&) = delete;
 	GameScene& operator=(const GameScene&) = delete;
@@ -21,6 +43,32 @@ public:
 	GameScene& operator=(GameScene&&) = delete;
 
 	void Update(TimeDuration dt) override;
+	// exactly one fixed step and the frame work after it, whatever time passed. for the stress
+	// test, where Update would run 0, 1 or 2 steps depending on the clock
+	void StepFrame();
+	// loads level states until the budget is used up, true once all of them are in
+	bool LoadStep(float budgetMs);
+	bool IsLoaded() const { return m_loadedStates == m_level.states.size(); }
+	// creates the scripts and takes the restart snapshot, cheap enough for the frame of the swap
+	void Activate();
+	const Level& GetLevel() const { return m_level; }
+	// restores the snapshot taken after load, false if the scene has to be rebuilt instead
+	bool Restart();
+	// restarts and simulates the whole log at once, no rendering and no server calls
+	RunResult Replay(const InputLog& log);
+
+	// recorded so a replay applies it at the same step
+	void ExternalEvent(InputEvent event);
+	// ends the log at the current step, false while replaying since nothing has to be reported
+	bool FinishRun(int32_t seconds);
+	bool IsReplaying() const { return m_replaying; }
+	// scratch scenes (benchmarks) must not ask the server for anything
+	void SetOffline(bool offline) { m_offline = offline; }
+	bool IsOffline() const { return m_offline || m_replaying; }
+	// the run ended with a win, until the next restart
+	bool HasWon() const { return m_result.won; }
+	// every fixed step since load or restart, until the win
+	const InputLog& GetInputLog() const { return m_inputLog; }
 
 	void SetControlHintHandler(const std::function<void(std::string_view)>& handler) {
 		m_controlHint = handler;
@@ -29,11 +77,46 @@ public:
 		m_controlHint(hint);
 	}
 
+	SceneBuilder& GetSceneBuilder() { return m_sceneBuilder; }
+	// seconds the scene was played, counted in fixed steps so replays see the same times
+	float GetPlayTime() const { return static_cast<float>(m_step) / InputLog::STEP_HZ; }
+	// duration of the last physics step, for the stress test
+	float GetPhysicsStepMs() const { return m_physicsStepMs; }
+
+	// owning groups keep these component arrays packed in the same order
+	auto MeshGroup() { return registry.group<MeshComponent, TransformComponent>(); }
+	auto BodyGroup() { return registry.group<RigidBodyComponent, FlagComponent>(); }
+
 	GameActions actions;
+	PhysicsSync physicsSync;
+	PhysicsQueries physicsQueries;
+	RenderQueue renderQueue;
 	Player player;
-	MainScript* mainScript;
-	KeyMapper keyMapper;
+	MainScript* mainScript = nullptr;
 
 private:
+	// everything that has to replay identically, player input, physics and scripts
+	void Step(const InputFrame& input);
+	// per rendered frame after the steps: camera, texts, highlights and the render queue
+	void DrawFrame();
+
+	const Level& m_level;
+	size_t m_loadedStates = 0;
 	std::function<void(std::string_view)> m_controlHint = [](std::string_view){};
+	float m_physicsStepMs = 0;
+	// summed over the fixed steps of the current frame
+	float m_physicsFrameMs = 0;
+	float m_scriptsFrameMs = 0;
+	uint32_t m_step = 0;
+	float m_stepBacklogMs = 0;
+	uint16_t m_lastKeys = 0;
+	InputLog m_inputLog;
+	bool m_recording = true;
+	bool m_replaying = false;
+	bool m_offline = false;
+	RunResult m_result;
+	SceneSnapshot m_snapshot;
+#ifdef SHADER_HOT_RELOAD
+	SceneEditTimer m_editTimer{registry};
+#endif
 };
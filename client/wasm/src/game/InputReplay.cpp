@@ -0,0 +1,52 @@
+#include "InputReplay.h"
+
+#include <cstdio>
+#include <emscripten/bind.h>
+#include <format>
+#include <optional>
+#include <wgleng/util/Timer.h>
+
+#include "GameScene.h"
+#include "util/InputLog.h"
+
+namespace {
+	std::optional<std::string> s_pendingLog;
+	int32_t s_claimedSeconds = -1;
+	std::string s_lastResult;
+}
+
+void RequestReplay(const std::string& inputLog, int32_t claimedSeconds) {
+	s_pendingLog = inputLog;
+	s_claimedSeconds = claimedSeconds;
+}
+
+bool RunPendingReplay(GameScene& scene) {
+	if (!s_pendingLog) return true;
+	const std::optional<InputLog> log = InputLog::DecodeBase64(*s_pendingLog);
+	s_pendingLog.reset();
+	if (!log) {
+		s_lastResult = R"({"valid":false,"reason":"malformed log"})";
+		std::printf("replay: %s\n", s_lastResult.c_str());
+		return true;
+	}
+
+	const TimePoint start;
+	const GameScene::RunResult result = scene.Replay(*log);
+	const float ms = (TimePoint() - start).fMilli();
+	const bool valid = result.won && result.seconds == s_claimedSeconds && result.steps == log->GetWinStep();
+	s_lastResult = std::format(R"({{"valid":{},"won":{},"steps":{},"seconds":{},"claimedSeconds":{},"replayMs":{:.2f}}})",
+		valid, result.won, result.steps, result.seconds, s_claimedSeconds, ms);
+	std::printf("replay: %s\n", s_lastResult.c_str());
+
+	// back to a fresh run for the player
+	return scene.Restart();
+}
+
+std::string getReplayResult() {
+	return s_lastResult;
+}
+
+EMSCRIPTEN_BINDINGS(input_replay) {
+	emscripten::function("replayInputLog", &RequestReplay);
+	emscripten::function("getReplayResult", &getReplayResult);
+}
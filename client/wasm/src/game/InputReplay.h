@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+class GameScene;
+
+// re-simulates an uploaded input log in the browser, the server only checks it for consistency.
+// call replayInputLog(log, seconds) from js, the result goes to the console and
+// getReplayResult() as json. the live scene is restarted before and after.
+void RequestReplay(const std::string& inputLog, int32_t claimedSeconds);
+// runs a requested replay, returns false if the scene could not restart in place and has to be rebuilt
+bool RunPendingReplay(GameScene& scene);
@@ -0,0 +1,112 @@
+#include "Levels.h"
+
+#include <emscripten/bind.h>
+#include <string>
+
+#include "../scenes/firstmap.h"
+#include "../scenes/world1.h"
+#ifdef SHADER_HOT_RELOAD
+#include "../scenes/test.h"
+#endif
+#include "GameScene.h"
+#include "RunLevel.h"
+#include "Telemetry.h"
+
+namespace {
+	constexpr Level LEVELS[] = {
+		{"firstmap", firstmap_states},
+		{"world1", world1_states},
+#ifdef SHADER_HOT_RELOAD
+		{"test", test_states},
+#endif
+	};
+
+	// per frame, on top of the frame itself
+	constexpr float STAGING_BUDGET_MS = 2.0f;
+	// the final time stays on screen for a moment before the next room
+	constexpr float SWITCH_DELAY_MS = 3000.0f;
+
+	const Level* s_current = &LEVELS[0];
+	const Level* s_requested = nullptr;
+	std::unique_ptr<GameScene> s_staged;
+	float s_sinceWinMs = 0;
+}
+
+std::span<const Level> Levels::GetAll() {
+	return LEVELS;
+}
+const Level& Levels::GetFirst() {
+	return LEVELS[0];
+}
+const Level* Levels::Find(std::string_view name) {
+	for (const Level& level : LEVELS) {
+		if (level.name == name) return &level;
+	}
+	return nullptr;
+}
+const Level* Levels::GetNext(const Level& level) {
+	const size_t index = &level - LEVELS;
+	return index + 1 < std::size(LEVELS) ? &LEVELS[index + 1] : nullptr;
+}
+
+std::shared_ptr<GameScene> Levels::Rebuild() {
+	s_sinceWinMs = 0;
+	Telemetry::SetScene(s_current->name);
+	return std::make_shared<GameScene>(*s_current);
+}
+
+bool Levels::Update(std::shared_ptr<Scene>& scene, TimeDuration dt) {
+	// nobody is waiting for the next level while nobody is looking
+	if (RunLevels::Get() != RunLevel::Full) return false;
+
+	const Level* next = s_requested ? s_requested : GetNext(*s_current);
+	if (!next) return false;
+	// a staged level is a second registry and physics world, only kept around from the win to the switch
+	const GameScene& current = static_cast<const GameScene&>(*scene);
+	if (!s_requested && !current.HasWon()) {
+		s_sinceWinMs = 0;
+		s_staged.reset();
+		return false;
+	}
+	if (current.HasWon()) s_sinceWinMs += dt.fMilli();
+	if (s_staged && &s_staged->GetLevel() != next) s_staged.reset();
+	if (!s_staged) {
+		s_staged = std::make_unique<GameScene>(*next, GameScene::LoadMode::Staged);
+		return false;
+	}
+	if (!s_staged->IsLoaded()) {
+		s_staged->LoadStep(STAGING_BUDGET_MS);
+		return false;
+	}
+
+	if (!s_requested && s_sinceWinMs < SWITCH_DELAY_MS) return false;
+
+	// scripts and the restart snapshot, the rest was built over the previous frames
+	s_staged->Activate();
+	s_current = next;
+	s_requested = nullptr;
+	s_sinceWinMs = 0;
+	Telemetry::SetScene(s_current->name);
+	scene = std::move(s_staged);
+	return true;
+}
+
+bool Levels::Request(std::string_view name) {
+	const Level* level = Find(name);
+	if (!level) return false;
+	s_requested = level;
+	return true;
+}
+
+void Levels::Shutdown() {
+	s_staged.reset();
+	s_requested = nullptr;
+}
+
+bool loadLevel(const std::string& name) {
+	return Levels::Request(name);
+}
+
+EMSCRIPTEN_BINDINGS(levels) {
+	emscripten::function("loadLevel", &loadLevel);
+}
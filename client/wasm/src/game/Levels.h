@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string_view>
+#include <wgleng/core/Scene.h>
+#include <wgleng/util/SceneBuilder.h>
+#include <wgleng/util/Timer.h>
+
+class GameScene;
+
+struct Level {
+	std::string_view name;
+	std::span<const SceneBuilder::State> states;
+};
+
+// level order and background loading. once a level is won the next one is built into its
+// own GameScene (registry, physics world, colliders) a few states per frame while the final
+// time is shown, then swapped in as a whole, so rooms chain without a loading screen.
+// two scenes are only alive between the win and the switch, the old one goes with the swap.
+namespace Levels {
+	// every level compiled into the module, in play order
+	std::span<const Level> GetAll();
+	const Level& GetFirst();
+	const Level* Find(std::string_view name);
+	// nullptr after the last level
+	const Level* GetNext(const Level& level);
+
+	// builds the current level right away, at start and when a restart can not be done in place
+	std::shared_ptr<GameScene> Rebuild();
+	// call every tick. after a win (or a request) stages the next level within a time budget
+	// and swaps it into `scene` once it is loaded and due, true when `scene` was replaced
+	bool Update(std::shared_ptr<Scene>& scene, TimeDuration dt);
+	// switches to the level as soon as it is loaded, false for unknown names
+	bool Request(std::string_view name);
+	// drops the level being staged
+	void Shutdown();
+}
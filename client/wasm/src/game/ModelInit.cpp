@@ -1,6 +1,7 @@
 #include "ModelInit.h"
 
 #include <wgleng/rendering/Mesh.h>
+#include <wgleng/rendering/Renderer.h>
 
 #include "../meshes/candle.h"
 #include "../meshes/chair.h"
@@ -12,6 +13,7 @@
 #include "../meshes/pencil.h"
 #include "../meshes/table.h"
 #include "../meshes/globe.h"
+#include "util/MemoryStats.h"
 
 // DO NOT CHANGE THE ORDER OF MESHES, it will break saved scenes
 #define XFUNC(func) \
@@ -26,21 +28,60 @@
     func(table); \
     func(globe);
 
+namespace {
+    bool s_uploaded = false;
+#ifdef WASMGAME_SLIM
+    // no wireframe toggle, the meshes carry only what is drawn
+    constexpr bool WITH_WIREFRAME = false;
+#else
+    // built once with the meshes, the toggle then only switches the renderer's mode
+    constexpr bool WITH_WIREFRAME = true;
+#endif
+}
+
+#define UPLOAD_MESH(mesh, name) do { \
+    if constexpr (WITH_WIREFRAME) mesh->Load(name##_vertices, name##_materials, name##_indices, true, true); \
+    else mesh->Load(name##_vertices, name##_materials, name##_indices); \
+} while(0)
+
 void LoadModels(SceneBuilder& sceneBuilder) {
     #define LOAD_MESH(name) do { \
         Mesh mesh = MeshRegistry::Create(#name); \
-        mesh->Load(name##_vertices, name##_materials, name##_indices); \
+        UPLOAD_MESH(mesh, name); \
         sceneBuilder.AddModel(#name); \
     } while(0)
 
+    #define ADD_MODEL(name) sceneBuilder.AddModel(#name)
+
+    // a level loaded while another is played must not replace the meshes it draws
+    if (s_uploaded) {
+        XFUNC(ADD_MODEL)
+        return;
+    }
+
+    MemoryTagScope scope(MemoryTag::Meshes);
     MeshRegistry::Clear();
 	XFUNC(LOAD_MESH)
+    s_uploaded = true;
 }
-void ReloadModels(bool showWireframe) {
-	#define RELOAD_MESH(name) do { \
+void ReloadModels() {
+    #define RELOAD_MESH(name) do { \
         Mesh mesh = MeshRegistry::Get(#name); \
-        mesh->Load(name##_vertices, name##_materials, name##_indices, true, showWireframe); \
+        UPLOAD_MESH(mesh, name); \
     } while(0)
 
-	XFUNC(RELOAD_MESH)
+    MemoryTagScope scope(MemoryTag::Meshes);
+    XFUNC(RELOAD_MESH)
+}
+int32_t GetModelIndex(std::string_view name) {
+    // the builder numbers models in the order they were added
+    int32_t index = 0;
+    #define MATCH_MODEL(model) if (name == #model) return index; index++
+
+    XFUNC(MATCH_MODEL)
+    return -1;
+}
+void ShowWireframe(Renderer& renderer, bool show) {
+    // the meshes got their wireframe data at load, nothing is uploaded or read here
+    renderer.ShowWireframe(show);
 }
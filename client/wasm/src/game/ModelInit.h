@@ -1,6 +1,19 @@
 #pragma once
 
+#include <stdint.h>
+#include <string_view>
 #include <wgleng/util/SceneBuilder.h>
 
+class Renderer;
+
+// registers every model with the builder. meshes are uploaded by the first call only,
+// later scenes share them
 void LoadModels(SceneBuilder& sceneBuilder);
-void ReloadModels(bool showWireframe = false);
\ No newline at end of file
+// uploads every registered mesh again in place with the data it already holds, what the
+// first LoadModels costs without replacing the meshes a live scene draws. for benchmarks
+void ReloadModels();
+// the model index a SceneBuilder::State refers to, -1 for unknown names
+int32_t GetModelIndex(std::string_view name);
+// wireframe is a renderer mode over the loaded meshes. builds with the toggle load the
+// wireframe data with the meshes once, toggling never uploads or reads vertex arrays
+void ShowWireframe(Renderer& renderer, bool show);
\ No newline at end of file
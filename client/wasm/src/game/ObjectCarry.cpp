@@ -3,6 +3,8 @@
 #include <wgleng/core/Components.h>
 #include <wgleng/core/PhysicsWorld.h>
 
+#include "systems/PhysicsSync.h"
+
 ObjectCarry::ObjectCarry(entt::registry& registry, float dropDist)
 	: m_registry{ registry }, m_dropDistance{ dropDist } {}
 
@@ -33,7 +35,7 @@ void ObjectCarry::DropCarriedEntity(const glm::vec3& direction, float force) {
 	m_body = nullptr;
 	m_pickupDistance = 0;
 }
-void ObjectCarry::Update(const glm::vec3& holderPos, const glm::vec3& holderFront) {
+void ObjectCarry::Update(const glm::vec3& holderPos, const glm::vec3& holderFront, const PhysicsSync& physicsSync) {
 	if (m_carriedEntity == entt::null) return;
 	if (!m_registry.valid(m_carriedEntity)) {
 		m_body = nullptr;
@@ -41,11 +43,10 @@ void ObjectCarry::Update(const glm::vec3& holderPos, const glm::vec3& holderFron
 		return;
 	}
 
-	// get current position
-	btTransform transform;
-	if (m_body->getMotionState()) m_body->getMotionState()->getWorldTransform(transform);
-	else transform = m_body->getWorldTransform();
-	const glm::vec3 pos = { transform.getOrigin().x(), transform.getOrigin().y(), transform.getOrigin().z() };
+	// get current position, pushed by physics sync
+	const btTransform* transform = physicsSync.GetTransform(m_carriedEntity);
+	if (!transform) transform = &m_body->getWorldTransform();
+	const glm::vec3 pos = { transform->getOrigin().x(), transform->getOrigin().y(), transform->getOrigin().z() };
 
 	// get distance
 	const float distance = glm::distance(pos, holderPos);
@@ -4,6 +4,7 @@
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
 
+class PhysicsSync;
 class ObjectCarry {
 public:
 	ObjectCarry(entt::registry& registry, float dropDist = 55.f);
@@ -12,7 +13,7 @@ public:
 	entt::entity GetCarriedEntity() const { return m_carriedEntity; }
 	void DropCarriedEntity(const glm::vec3& direction = {0, 0, 0}, float force = 0);
 
-	void Update(const glm::vec3& holderPos, const glm::vec3& holderFront);
+	void Update(const glm::vec3& holderPos, const glm::vec3& holderFront, const PhysicsSync& physicsSync);
 
 	bool canDropByItself = true;
 
@@ -1,13 +1,20 @@
 #include "Player.h"
 
+#include <algorithm>
 #include <glm/gtx/norm.hpp>
+#include <utility>
 #include <wgleng/core/Components.h>
 #include <wgleng/io/Input.h>
 
+#include "systems/PhysicsSync.h"
+#include "util/RawMouse.h"
+
 Player::Player(entt::registry& registry, PhysicsWorld& physicsWorld, const glm::vec3& position)
 	: objectCarry{registry}, m_physicsWorld{physicsWorld}, m_entity{registry.create()}, m_registry{registry} {
 	m_camera = std::make_shared<Camera>();
 	m_camera->position = position;
+	m_stepPosition = position;
+	m_previousStepPosition = position;
 
 	const auto collider = m_physicsWorld.get().GetCapsuleCollider(10, 20);
 	m_rigidBody = m_physicsWorld.get().CreateRigidBody(m_entity, collider, 50.f, position, {0, 0, 0});
@@ -23,7 +30,8 @@ Player::~Player() {
 }
 Player::Player(Player&& other) noexcept
 	: objectCarry{other.m_registry}, m_physicsWorld{other.m_physicsWorld}, m_rigidBody{other.m_rigidBody}, m_camera{other.m_camera},
-	  m_entity{other.m_entity}, m_registry{other.m_registry} {
+	  m_entity{other.m_entity}, m_registry{other.m_registry}, m_stepPosition{other.m_stepPosition},
+	  m_previousStepPosition{other.m_previousStepPosition} {
 	other.m_rigidBody = nullptr;
 }
 Player& Player::operator=(Player&& other) noexcept {
@@ -34,6 +42,8 @@ Player& Player::operator=(Player&& other) noexcept {
 		m_camera = std::move(other.m_camera);
 		m_entity = other.m_entity;
 		m_registry = other.m_registry;
+		m_stepPosition = other.m_stepPosition;
+		m_previousStepPosition = other.m_previousStepPosition;
 		other.m_rigidBody = nullptr;
 	}
 	return *this;
@@ -44,29 +54,101 @@ void Player::Cleanup() {
 	m_registry.get().destroy(m_entity);
 }
 
-void Player::Update(float dt) {
-	UpdateInput(dt);
+Player::State Player::CaptureState() const {
+	return {*m_camera, m_rigidBody->getWorldTransform()};
+}
+void Player::RestoreState(const State& state) {
+	objectCarry.DropCarriedEntity();
+	*m_camera = state.camera;
+	m_stepPosition = m_camera->position;
+	m_previousStepPosition = m_camera->position;
+	m_sinceJump = 0;
+	m_lookRemainder = glm::vec2{0};
+	m_pendingLookX = 0;
+	m_pendingLookY = 0;
+	m_rigidBody->clearForces();
+	m_rigidBody->setWorldTransform(state.transform);
+	m_rigidBody->setInterpolationWorldTransform(state.transform);
+	m_rigidBody->setLinearVelocity({0, 0, 0});
+	if (auto* motionState = m_rigidBody->getMotionState()) motionState->setWorldTransform(state.transform);
+	m_rigidBody->activate(true);
 }
-void Player::UpdateCameraAfterPhysics() const {
-	btTransform transform;
-	if (m_rigidBody->getMotionState()) m_rigidBody->getMotionState()->getWorldTransform(transform);
-	else transform = m_rigidBody->getWorldTransform();
 
-	m_camera->position = {transform.getOrigin().x(), transform.getOrigin().y() + 15.f, transform.getOrigin().z()};
+void Player::Update(float dt, const InputFrame& input) {
+	UpdateInput(dt, input);
+}
+void Player::UpdateCameraAfterPhysics(const PhysicsSync& physicsSync) {
+	// camera only follows when the body actually moved
+	m_previousStepPosition = m_stepPosition;
+	if (const btTransform* transform = physicsSync.GetMovedTransform(m_entity)) {
+		const btVector3& origin = transform->getOrigin();
+		m_stepPosition = {origin.x(), origin.y() + 15.f, origin.z()};
+	}
+	m_camera->position = m_stepPosition;
+}
+void Player::InterpolateCamera(float alpha) const {
+	m_camera->position = glm::mix(m_previousStepPosition, m_stepPosition, std::clamp(alpha, 0.0f, 1.0f));
+}
+void Player::SnapCameraToStep() const {
+	m_camera->position = m_stepPosition;
+}
+void Player::ApplyMouseLook() {
+	const glm::vec2 motion = RawMouse::Consume();
+	if (!Input::IsHeldMouse(SDL_BUTTON_LEFT)) {
+		m_lookRemainder = glm::vec2{0};
+		return;
+	}
+	m_lookRemainder += motion;
+	const glm::vec2 whole = glm::trunc(m_lookRemainder);
+	m_lookRemainder -= whole;
+	const auto x = static_cast<int16_t>(std::clamp(whole.x, -1000.0f, 1000.0f));
+	const auto y = static_cast<int16_t>(std::clamp(whole.y, -1000.0f, 1000.0f));
+	if (x == 0 && y == 0) return;
+	ApplyLook(x, y);
+	m_pendingLookX += x;
+	m_pendingLookY += y;
 }
-void Player::UpdateInput(float dt) {
+void Player::ApplyLook(int16_t x, int16_t y) const {
+	m_camera->Rotate(x * mouseSensitivity, -y * mouseSensitivity);
+}
+uint16_t Player::CurrentKeys() {
+	constexpr std::pair<SDL_Scancode, InputFrame::Key> keys[] = {
+		{SDL_SCANCODE_W, InputFrame::FORWARD},
+		{SDL_SCANCODE_S, InputFrame::BACK},
+		{SDL_SCANCODE_A, InputFrame::LEFT},
+		{SDL_SCANCODE_D, InputFrame::RIGHT},
+		{SDL_SCANCODE_SPACE, InputFrame::JUMP},
+		{SDL_SCANCODE_LSHIFT, InputFrame::SPRINT},
+		{SDL_SCANCODE_C, InputFrame::DOWN},
+		{SDL_SCANCODE_F, InputFrame::PICKUP},
+		{SDL_SCANCODE_Q, InputFrame::THROW},
+		{SDL_SCANCODE_E, InputFrame::INTERACT},
+	};
+	uint16_t result = 0;
+	for (const auto& [scancode, key] : keys) {
+		if (Input::IsHeld(scancode) || Input::JustPressed(scancode)) result |= key;
+	}
+	return result;
+}
+void Player::PollKeys() {
+	m_polledKeys |= CurrentKeys();
+}
+InputFrame Player::TakeInput() {
+	InputFrame input;
+	input.keys = m_polledKeys | CurrentKeys();
+	m_polledKeys = 0;
+	// a step can only carry what fits, the rest goes to the next one
+	input.lookX = static_cast<int16_t>(std::clamp(m_pendingLookX, -32767, 32767));
+	input.lookY = static_cast<int16_t>(std::clamp(m_pendingLookY, -32767, 32767));
+	m_pendingLookX -= input.lookX;
+	m_pendingLookY -= input.lookY;
+	return input;
+}
+void Player::UpdateInput(float dt, const InputFrame& input) {
 	// user data
 	auto userData = static_cast<RigidBodyUserData*>(m_rigidBody->getUserPointer());
 
-	// mouse
-	glm::vec2 mousePos = Input::GetMousePosition();
-	static glm::vec2 lastMousePos = mousePos;
-	glm::vec2 mouseDelta = (mousePos - lastMousePos) * mouseSensitivity;
-	lastMousePos = mousePos;
-
-	if (Input::IsHeldMouse(SDL_BUTTON_LEFT)) m_camera->Rotate(mouseDelta.x, -mouseDelta.y);
-
-	// keyboard
+	// keyboard, mouse look is applied in ApplyMouseLook
 	glm::vec3 front = m_camera->GetFront();
 	if (!fly) {
 		front.y = 0;
@@ -75,22 +157,23 @@ void Player::UpdateInput(float dt) {
 
 	float speed = moveSpeed;
 	glm::vec3 velocity{0};
-	if (Input::IsHeld(SDL_SCANCODE_LSHIFT)) speed *= 2.f;
+	if (input.IsHeld(InputFrame::SPRINT)) speed *= 2.f;
 
-	if (Input::IsHeld(SDL_SCANCODE_W)) velocity += front;
-	if (Input::IsHeld(SDL_SCANCODE_S)) velocity -= front;
-	if (Input::IsHeld(SDL_SCANCODE_A)) velocity -= glm::cross(front, m_camera->GetUp());
-	if (Input::IsHeld(SDL_SCANCODE_D)) velocity += glm::cross(front, m_camera->GetUp());
+	if (input.IsHeld(InputFrame::FORWARD)) velocity += front;
+	if (input.IsHeld(InputFrame::BACK)) velocity -= front;
+	if (input.IsHeld(InputFrame::LEFT)) velocity -= glm::cross(front, m_camera->GetUp());
+	if (input.IsHeld(InputFrame::RIGHT)) velocity += glm::cross(front, m_camera->GetUp());
 	// normalize velocity to avoid faster diagonal movement
 	if (glm::length2(velocity) > 0) {
 		velocity = glm::normalize(velocity) * speed * glm::sqrt(dt); // not correct but kinda works independently of fps
 	}
 
 	glm::vec3 vertical = m_camera->GetUp() * moveSpeed * 4.f;
-	if (fly && Input::IsHeld(SDL_SCANCODE_C)) velocity -= vertical;
-	if ((fly || (userData->onGround && TimePoint() - m_lastJump > 250ms)) && Input::IsHeld(SDL_SCANCODE_SPACE)) {
+	m_sinceJump += dt;
+	if (fly && input.IsHeld(InputFrame::DOWN)) velocity -= vertical;
+	if ((fly || (userData->onGround && m_sinceJump > 250.0f)) && input.IsHeld(InputFrame::JUMP)) {
 		velocity += vertical;
-		m_lastJump.reset();
+		m_sinceJump = 0;
 	}
 	if (!userData->onGround) {
 		velocity *= 0.5f;
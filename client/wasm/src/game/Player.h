@@ -7,9 +7,17 @@
 #include <wgleng/util/Timer.h>
 
 #include "ObjectCarry.h"
+#include "util/InputLog.h"
+
+class PhysicsSync;
 
 class Player {
 public:
+	struct State {
+		Camera camera;
+		btTransform transform;
+	};
+
 	Player(entt::registry& registry, PhysicsWorld& physicsWorld, const glm::vec3& position);
 	~Player();
 	Player(const Player&) = delete;
@@ -17,8 +25,27 @@ public:
 	Player(Player&& other) noexcept;
 	Player& operator=(Player&& other) noexcept;
 
-	void Update(float dt);
-	void UpdateCameraAfterPhysics() const;
+	// one fixed step of movement from the given input
+	void Update(float dt, const InputFrame& input);
+	void UpdateCameraAfterPhysics(const PhysicsSync& physicsSync);
+	// steps run at 60 Hz, frames may not. the camera is drawn between the last two step
+	// positions, `alpha` is the part of a step since the last one
+	void InterpolateCamera(float alpha) const;
+	// back to the position of the last step, before the next one simulates
+	void SnapCameraToStep() const;
+	// rotates the camera by all mouse motion so far, call as late as possible before rendering.
+	// whole pixels are kept for the next TakeInput, the fraction carries over
+	void ApplyMouseLook();
+	// the same rotation ApplyMouseLook does, for replaying a log
+	void ApplyLook(int16_t x, int16_t y) const;
+	// call every frame, a key tapped between two fixed steps still counts as held for one
+	void PollKeys();
+	// keys held since the last call and the look applied since, for the next fixed step
+	InputFrame TakeInput();
+
+	// position and view only, for restarting in place
+	State CaptureState() const;
+	void RestoreState(const State& state);
 
 	void SetCamera(const std::shared_ptr<Camera>& camera) { m_camera = camera; }
 	const std::shared_ptr<Camera>& GetCamera() const { return m_camera; }
@@ -31,11 +58,19 @@ public:
 
 private:
 	void Cleanup();
-	void UpdateInput(float dt);
+	static uint16_t CurrentKeys();
+	void UpdateInput(float dt, const InputFrame& input);
 	std::reference_wrapper<PhysicsWorld> m_physicsWorld;
 	btRigidBody* m_rigidBody;
 	std::shared_ptr<Camera> m_camera;
-	TimePoint m_lastJump;
+	// simulated ms, wall clock time would differ between play and replay
+	float m_sinceJump = 0;
+	uint16_t m_polledKeys = 0;
+	glm::vec2 m_lookRemainder{0};
+	int32_t m_pendingLookX = 0;
+	int32_t m_pendingLookY = 0;
 	entt::entity m_entity;
 	std::reference_wrapper<entt::registry> m_registry;
+	glm::vec3 m_stepPosition;
+	glm::vec3 m_previousStepPosition;
 };
@@ -0,0 +1,91 @@
+#include "QualityGovernor.h"
+
+#include "RendererConfig.h"
+
+namespace {
+	using FXAA = RendererSettings::FXAAPreset;
+	using Shadows = RendererSettings::ShadowPreset;
+	using Outlines = RendererSettings::OutlinePreset;
+
+	bool LowerShadows(RendererSettings& settings) {
+		switch (settings.shadows) {
+		case Shadows::HIGH: settings.shadows = Shadows::MEDIUM; return true;
+		case Shadows::MEDIUM: settings.shadows = Shadows::LOW; return true;
+		case Shadows::LOW: settings.shadows = Shadows::OFF; return true;
+		default: return false;
+		}
+	}
+	bool LowerFXAA(RendererSettings& settings) {
+		switch (settings.fxaa) {
+		case FXAA::HIGH: settings.fxaa = FXAA::LOW; return true;
+		case FXAA::LOW: settings.fxaa = FXAA::OFF; return true;
+		default: return false;
+		}
+	}
+	bool LowerOutlines(RendererSettings& settings) {
+		if (settings.outlines == Outlines::OFF) return false;
+		settings.outlines = Outlines::OFF;
+		return true;
+	}
+
+	// cheapest visual loss first
+	constexpr bool (*LADDER_STEPS[])(RendererSettings&) = {
+		LowerShadows,
+		LowerFXAA,
+		LowerShadows,
+		LowerOutlines,
+		LowerShadows,
+		LowerFXAA,
+	};
+}
+
+QualityGovernor::QualityGovernor() {
+	m_levels.push_back(RendererSettings{});
+}
+
+void QualityGovernor::SetEnabled(bool enabled) {
+	if (m_enabled == enabled) return;
+	m_enabled = enabled;
+	// disabling goes back to the full preset
+	m_adaptive.Restart();
+	m_dirty = true;
+}
+void QualityGovernor::SetPaused(bool paused) {
+	if (m_paused == paused) return;
+	m_paused = paused;
+	m_dirty = true;
+	m_adaptive.ClearSamples();
+}
+void QualityGovernor::SetCeiling(const RendererSettings& settings) {
+	m_hasCeiling = true;
+	BuildLadder(settings);
+	m_adaptive.SetLevelCount(static_cast<uint32_t>(m_levels.size()));
+	m_dirty = true;
+}
+void QualityGovernor::SetTargetFps(float fps) {
+	m_adaptive.SetTargetFps(fps);
+}
+
+void QualityGovernor::BuildLadder(const RendererSettings& ceiling) {
+	m_levels.clear();
+	RendererSettings settings = ceiling;
+	m_levels.push_back(settings);
+	for (const auto step : LADDER_STEPS) {
+		if (step(settings)) m_levels.push_back(settings);
+	}
+}
+void QualityGovernor::Apply(Renderer& renderer) {
+	RendererConfig::Apply(renderer, m_enabled ? m_levels[m_adaptive.GetLevel()] : m_levels.front());
+}
+
+void QualityGovernor::Update(Renderer& renderer, TimeDuration dt) {
+	// the engine loads the saved preset, take it as the ceiling once
+	if (!m_hasCeiling) SetCeiling(renderer.GetSettings());
+	if (m_paused) return;
+
+	if (m_enabled && m_adaptive.AddFrame(dt.fMilli())) m_dirty = true;
+	if (m_dirty) {
+		m_dirty = false;
+		Apply(renderer);
+	}
+}
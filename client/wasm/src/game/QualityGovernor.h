@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <wgleng/rendering/Renderer.h>
+#include <wgleng/util/Timer.h>
+
+#include "util/AdaptiveLevel.h"
+
+// adaptive quality, off unless the user turns it on. walks a ladder of renderer settings
+// to hold the target frame rate, AdaptiveLevel decides when to move. level 0 is the
+// user's saved preset, the governor never goes above it.
+class QualityGovernor {
+public:
+	QualityGovernor();
+
+	void SetEnabled(bool enabled);
+	bool IsEnabled() const { return m_enabled; }
+	// while paused (settings screen open) nothing is applied
+	void SetPaused(bool paused);
+	// the saved preset, rebuilds the ladder and restarts at the top
+	void SetCeiling(const RendererSettings& settings);
+	const RendererSettings& GetCeiling() const { return m_levels.front(); }
+	void SetTargetFps(float fps);
+
+	void Update(Renderer& renderer, TimeDuration dt);
+
+	uint32_t GetLevel() const { return m_adaptive.GetLevel(); }
+	uint32_t GetLevelCount() const { return static_cast<uint32_t>(m_levels.size()); }
+	float GetFrameTimeP50() const { return m_adaptive.GetFrameTimeP50(); }
+	float GetFrameTimeP90() const { return m_adaptive.GetFrameTimeP90(); }
+
+private:
+	void BuildLadder(const RendererSettings& ceiling);
+	void Apply(Renderer& renderer);
+
+	std::vector<RendererSettings> m_levels;
+	AdaptiveLevel m_adaptive;
+	bool m_enabled = false;
+	bool m_paused = false;
+	bool m_hasCeiling = false;
+	bool m_dirty = true;
+};
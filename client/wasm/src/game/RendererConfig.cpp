@@ -0,0 +1,41 @@
+#include "RendererConfig.h"
+
+#include <wgleng/util/Timer.h>
+
+namespace {
+	RendererConfig::Report s_lastReport{};
+
+	void Set(Renderer& renderer, const RendererSettings& settings, bool save, uint8_t changes) {
+		const TimePoint start;
+		renderer.SetSettings(settings, save);
+		s_lastReport = {changes, (TimePoint() - start).fMilli()};
+	}
+}
+
+uint8_t RendererConfig::Diff(const RendererSettings& from, const RendererSettings& to) {
+	uint8_t changes = NONE;
+	if (from.fxaa != to.fxaa) changes |= FXAA;
+	if (from.shadows != to.shadows) changes |= SHADOWS;
+	if (from.outlines != to.outlines) changes |= OUTLINES;
+	return changes;
+}
+
+uint8_t RendererConfig::Apply(Renderer& renderer, const RendererSettings& settings) {
+	const uint8_t changes = Diff(renderer.GetSettings(), settings);
+	if (changes != NONE) Set(renderer, settings, false, changes);
+	return changes;
+}
+void RendererConfig::Save(Renderer& renderer, const RendererSettings& settings) {
+	Set(renderer, settings, true, Diff(renderer.GetSettings(), settings));
+}
+
+const RendererConfig::Report& RendererConfig::GetLastReport() {
+	return s_lastReport;
+}
+const char* RendererConfig::DescribeChanges(uint8_t changes) {
+	constexpr const char* NAMES[] = {
+		"none", "fxaa", "shadows", "fxaa shadows",
+		"outlines", "fxaa outlines", "shadows outlines", "fxaa shadows outlines",
+	};
+	return NAMES[changes & (FXAA | SHADOWS | OUTLINES)];
+}
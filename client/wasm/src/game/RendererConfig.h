@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+#include <wgleng/rendering/Renderer.h>
+
+// every renderer settings change goes through here. settings are compared with what the
+// renderer runs with, unchanged presets never reach SetSettings, and each change is timed.
+namespace RendererConfig {
+	// preset groups, each owns its own gpu resources in the renderer. SetSettings still
+	// rebuilds all of them, the bits say which change was asked for
+	enum Change : uint8_t {
+		NONE = 0,
+		FXAA = 1 << 0,     // fxaa pass
+		SHADOWS = 1 << 1,  // shadow map size and pass
+		OUTLINES = 1 << 2, // outline pass
+	};
+
+	struct Report {
+		uint8_t changes;
+		float ms;
+	};
+
+	uint8_t Diff(const RendererSettings& from, const RendererSettings& to);
+	// NONE without touching the renderer when nothing differs
+	uint8_t Apply(Renderer& renderer, const RendererSettings& settings);
+	// persists the settings, always applies
+	void Save(Renderer& renderer, const RendererSettings& settings);
+
+	// the last change that reached the renderer
+	const Report& GetLastReport();
+	// "fxaa shadows", for the settings screen
+	const char* DescribeChanges(uint8_t changes);
+}
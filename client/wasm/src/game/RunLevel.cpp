@@ -0,0 +1,98 @@
+#include "RunLevel.h"
+
+#include <emscripten/bind.h>
+#include <emscripten/emscripten.h>
+#include <emscripten/html5.h>
+
+namespace {
+	// 20 fps at 60 Hz
+	constexpr int REDUCED_SWAP_INTERVAL = 3;
+
+	bool s_visible = true;
+	// paused by us, the visibility callback still runs and resumes it
+	bool s_paused = false;
+	// canvas state the page already reports to the engine through setHidden/setFocused
+	bool s_hidden = false;
+	bool s_focused = true;
+	RunLevel s_level = RunLevel::Full;
+
+	void Apply() {
+		s_level = RunLevel::Full;
+		if (!s_visible || s_hidden) s_level = RunLevel::Suspended;
+		else if (!s_focused) s_level = RunLevel::Reduced;
+	}
+
+	EM_BOOL OnVisibilityChange(int, const EmscriptenVisibilityChangeEvent* event, void*) {
+		s_visible = !event->hidden;
+		Apply();
+		if (s_visible && s_paused) {
+			s_paused = false;
+			emscripten_resume_main_loop();
+		}
+		return EM_FALSE;
+	}
+
+	void SetHidden(bool hidden) {
+		// the engine sets up its own main loop for the canvas, ours is not paused anymore
+		s_paused = false;
+		s_hidden = hidden;
+		Apply();
+	}
+	void SetFocused(bool focused) {
+		s_focused = focused;
+		Apply();
+	}
+}
+
+void RunLevels::Update() {
+	// a hidden canvas is the engine's, setHidden already changed its main loop
+	if (s_hidden) return;
+
+	// a hidden tab runs no frames at all. paused after this tick, so it still sends telemetry
+	if (s_level == RunLevel::Suspended) {
+		if (!s_paused) {
+			s_paused = true;
+			emscripten_pause_main_loop();
+		}
+		return;
+	}
+
+	const int mode = EM_TIMING_RAF;
+	const int value = s_level == RunLevel::Reduced ? REDUCED_SWAP_INTERVAL : 1;
+	// compared with the live timing, the engine restarts the loop when the canvas is shown again
+	int currentMode = 0, currentValue = 0;
+	emscripten_get_main_loop_timing(&currentMode, &currentValue);
+	if (currentMode == mode && currentValue == value) return;
+	// from inside the main loop, so there is a loop to retime
+	emscripten_set_main_loop_timing(mode, value);
+}
+
+void RunLevels::Install() {
+	EmscriptenVisibilityChangeEvent visibility;
+	if (emscripten_get_visibility_status(&visibility) == EMSCRIPTEN_RESULT_SUCCESS) s_visible = !visibility.hidden;
+	s_focused = EM_ASM_INT({ return document.activeElement === Module['canvas'] ? 1 : 0; }) != 0;
+	emscripten_set_visibilitychange_callback(nullptr, EM_FALSE, OnVisibilityChange);
+
+	// the engine's setHidden throws to change the main loop, so ours goes first
+	EM_ASM({
+		const setHidden = Module['setHidden'];
+		const setFocused = Module['setFocused'];
+		Module['setHidden'] = (hidden) => {
+			Module['runLevelSetHidden'](hidden);
+			setHidden(hidden);
+		};
+		Module['setFocused'] = (focused) => {
+			Module['runLevelSetFocused'](focused);
+			setFocused(focused);
+		};
+	});
+	Apply();
+}
+RunLevel RunLevels::Get() {
+	return s_level;
+}
+
+EMSCRIPTEN_BINDINGS(run_levels) {
+	emscripten::function("runLevelSetHidden", &SetHidden);
+	emscripten::function("runLevelSetFocused", &SetFocused);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+
+// how much work the game does depending on whether anyone is looking at it.
+// full: every frame. reduced (canvas not focused): the main loop runs every few
+// vsyncs. suspended (tab hidden or canvas scrolled away): physics, scripts and the
+// play timer stop, a hidden tab pauses the main loop until it is shown again.
+// canvas state comes from the page's existing setHidden/setFocused calls.
+enum class RunLevel : uint8_t {
+	Full,
+	Reduced,
+	Suspended,
+};
+
+namespace RunLevels {
+	// listens to page visibility and hooks into setHidden/setFocused
+	void Install();
+	// keeps the main loop timed for the level, call every tick
+	void Update();
+	RunLevel Get();
+}
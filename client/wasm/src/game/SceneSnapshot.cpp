@@ -0,0 +1,102 @@
+#include "SceneSnapshot.h"
+
+#include <algorithm>
+#include <wgleng/core/PhysicsWorld.h>
+
+#include "GameScene.h"
+#include "scripts/MainScript.h"
+
+namespace {
+	bool EntityLess(entt::entity a, entt::entity b) {
+		return entt::to_integral(a) < entt::to_integral(b);
+	}
+}
+
+void SceneSnapshot::Capture(GameScene& scene) {
+	auto& registry = scene.registry;
+	m_entities.clear();
+	m_bodies.clear();
+
+	for (auto&& [entity, transformComp] : registry.view<TransformComponent>(entt::exclude<PlayerComponent>).each()) {
+		const auto* flagComp = registry.try_get<FlagComponent>(entity);
+		const auto* meshComp = registry.try_get<MeshComponent>(entity);
+		m_entities.push_back({entity, transformComp, flagComp ? *flagComp : FlagComponent{}, meshComp != nullptr,
+			meshComp ? *meshComp : MeshComponent{}});
+
+		const auto* rbComp = registry.try_get<RigidBodyComponent>(entity);
+		if (!rbComp || !rbComp->body) continue;
+		const btRigidBody* body = rbComp->body;
+		m_bodies.push_back({entity, body->getWorldTransform(), body->getLinearVelocity(), body->getAngularVelocity(),
+			body->getActivationState()});
+	}
+	std::sort(m_entities.begin(), m_entities.end(), [](const EntityState& a, const EntityState& b) {
+		return EntityLess(a.entity, b.entity);
+	});
+
+	m_player = scene.player.CaptureState();
+}
+
+bool SceneSnapshot::Restore(GameScene& scene) const {
+	auto& registry = scene.registry;
+	if (m_entities.empty()) return false;
+	for (const auto& state : m_entities) {
+		if (!registry.valid(state.entity)) return false;
+	}
+
+	// scripts first, they clean up what they created (the book being read)
+	scene.player.objectCarry.DropCarriedEntity();
+	scene.mainScript->Restart();
+
+	// anything else created during play
+	std::vector<entt::entity> created;
+	for (const auto entity : registry.view<TransformComponent>(entt::exclude<PlayerComponent>)) {
+		const auto it = std::lower_bound(m_entities.begin(), m_entities.end(), entity, [](const EntityState& state, entt::entity e) {
+			return EntityLess(state.entity, e);
+		});
+		if (it == m_entities.end() || it->entity != entity) created.push_back(entity);
+	}
+	registry.destroy(created.begin(), created.end());
+
+	for (const auto& state : m_entities) {
+		registry.get<TransformComponent>(state.entity) = state.transform;
+		if (state.hasMesh) {
+			if (auto* meshComp = registry.try_get<MeshComponent>(state.entity)) *meshComp = state.mesh;
+		}
+		if (registry.all_of<FlagComponent>(state.entity)) {
+			// goes through on_update, physics queries re-bucket the entity
+			registry.patch<FlagComponent>(state.entity, [&](FlagComponent& flagComp) { flagComp = state.flags; });
+		}
+	}
+
+	for (const auto& state : m_bodies) {
+		const auto* rbComp = registry.try_get<RigidBodyComponent>(state.entity);
+		if (!rbComp || !rbComp->body) continue;
+		btRigidBody* body = rbComp->body;
+
+		const auto flags = registry.get<FlagComponent>(state.entity).flags;
+		if (flags & EntityFlags::DISABLE_COLLISIONS) PhysicsWorld::BodyDisableCollisions(body);
+		else PhysicsWorld::BodyEnableCollisions(body);
+		if (flags & EntityFlags::DISABLE_GRAVITY) PhysicsWorld::BodyDisableGravity(body);
+		else PhysicsWorld::BodyEnableGravity(body);
+
+		body->clearForces();
+		body->setWorldTransform(state.transform);
+		body->setInterpolationWorldTransform(state.transform);
+		body->setLinearVelocity(state.linearVelocity);
+		body->setAngularVelocity(state.angularVelocity);
+		body->setInterpolationLinearVelocity(state.linearVelocity);
+		body->setInterpolationAngularVelocity(state.angularVelocity);
+		// keeps physics sync's last known transform right for bodies that stay asleep
+		if (auto* motionState = body->getMotionState()) motionState->setWorldTransform(state.transform);
+		body->forceActivationState(state.activationState);
+		// moved bodies need their broadphase bounds refreshed by one simulated step
+		if (!body->isStaticOrKinematicObject()) body->activate(true);
+	}
+
+	RestorePlayer(scene);
+	return true;
+}
+
+void SceneSnapshot::RestorePlayer(GameScene& scene) const {
+	scene.player.RestoreState(m_player);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <btBulletDynamicsCommon.h>
+#include <entt/entt.hpp>
+#include <vector>
+#include <wgleng/core/Components.h>
+
+#include "Player.h"
+
+class GameScene;
+
+// copy of everything a play session changes: transforms, flags, mesh highlights,
+// rigid body motion, the player and script state. captured right after load, restoring
+// it restarts the attempt in place, without reloading meshes or fetching hints again.
+class SceneSnapshot {
+public:
+	void Capture(GameScene& scene);
+	// false if an entity the snapshot knows about was destroyed, the scene has to be
+	// rebuilt then. scripts hide what they take away (the secret door) instead
+	bool Restore(GameScene& scene) const;
+	void RestorePlayer(GameScene& scene) const;
+
+	bool IsEmpty() const { return m_entities.empty(); }
+
+private:
+	struct EntityState {
+		entt::entity entity;
+		TransformComponent transform;
+		FlagComponent flags;
+		bool hasMesh;
+		MeshComponent mesh;
+	};
+	struct BodyState {
+		entt::entity entity;
+		btTransform transform;
+		btVector3 linearVelocity;
+		btVector3 angularVelocity;
+		int activationState;
+	};
+
+	// sorted by entity, for lookups while finding entities created since
+	std::vector<EntityState> m_entities;
+	std::vector<BodyState> m_bodies;
+	Player::State m_player;
+};
@@ -8,7 +8,12 @@ class Script {
 public:
 	Script(GameScene& scene) : scene(scene) {}
 	virtual ~Script() = default;
-	virtual void Update(TimeDuration dt) = 0;
+	// one fixed simulation step, everything a replay has to reproduce
+	virtual void Update(TimeDuration dt) {}
+	// once per rendered frame after the steps: texts, highlights and whatever follows the camera
+	virtual void Draw() {}
+	// back to the state right after scene load, keeps what was fetched since
+	virtual void Restart() {}
 
 	void MarkForDestruction() {
 		m_markedForDestruction = true;
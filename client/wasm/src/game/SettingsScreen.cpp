@@ -1,14 +1,75 @@
 #include "SettingsScreen.h"
 
-#include <array>
-#include <span>
-#include <utility>
+#include <emscripten/emscripten.h>
+#include <format>
+#include <iterator>
+#include <wgleng/io/Input.h>
+#include <wgleng/rendering/Highlights.h>
 #include <wgleng/rendering/Renderer.h>
-#include <wgleng/vendor/imgui/imgui.h>
 
-SettingsScreen::SettingsScreen() {
+#include "QualityGovernor.h"
+#include "RendererConfig.h"
+#include "util/MemoryStats.h"
+
+namespace {
+	template <typename T>
+	struct Option {
+		const char* name;
+		T value;
+	};
+
+	constexpr Option<RendererSettings::FXAAPreset> FXAA_OPTIONS[] = {
+		{"Off", RendererSettings::FXAAPreset::OFF},
+		{"Low", RendererSettings::FXAAPreset::LOW},
+		{"High", RendererSettings::FXAAPreset::HIGH},
+	};
+	constexpr Option<RendererSettings::ShadowPreset> SHADOW_OPTIONS[] = {
+		{"Off", RendererSettings::ShadowPreset::OFF},
+		{"Low", RendererSettings::ShadowPreset::LOW},
+		{"Medium", RendererSettings::ShadowPreset::MEDIUM},
+		{"High", RendererSettings::ShadowPreset::HIGH},
+	};
+	constexpr Option<RendererSettings::OutlinePreset> OUTLINE_OPTIONS[] = {
+		{"Off", RendererSettings::OutlinePreset::OFF},
+		{"On", RendererSettings::OutlinePreset::ON},
+	};
+
+	constexpr float TEXT_SCALE = 0.03f;
+	constexpr float LINE_SPACING = 0.015f;
+
+	template <typename T, size_t N>
+	const char* GetOptionName(const Option<T> (&options)[N], T value) {
+		for (const auto& option : options) {
+			if (option.value == value) return option.name;
+		}
+		return "?";
+	}
+	// moves to the neighbouring option, stops at both ends
+	template <typename T, size_t N>
+	void StepOption(const Option<T> (&options)[N], T& value, int32_t direction) {
+		size_t index = 0;
+		while (index < N && options[index].value != value) index++;
+		if (index == N) index = 0;
+		const int64_t next = static_cast<int64_t>(index) + direction;
+		if (next < 0 || next >= static_cast<int64_t>(N)) return;
+		value = options[next].value;
+	}
+}
+
+SettingsScreen::SettingsScreen(QualityGovernor& governor)
+	: m_governor(governor) {
 	m_settings = new RendererSettings();
 	m_settingsOld = new RendererSettings();
+
+	// adaptive quality is off unless the user turned it on
+	const bool adaptive = EM_ASM_INT({
+		try {
+			return localStorage.getItem('adaptiveQuality') === '1' ? 1 : 0;
+		} catch (e) {
+			return 0;
+		}
+	});
+	m_governor.SetEnabled(adaptive);
 }
 SettingsScreen::~SettingsScreen() {
 	delete m_settings;
@@ -17,105 +78,123 @@ SettingsScreen::~SettingsScreen() {
 	m_settingsOld = nullptr;
 }
 
-template <typename T>
-bool DropdownSetting(const char* settingName, const std::vector<std::pair<std::string, T>>& vals, T& selection) {
-	bool changed = false;
-	ImGui::Text("%s", settingName);
-	ImGui::SameLine();
-	ImGui::PushID(999);
-	ImGui::PushID(settingName);
-	const char* preview = nullptr;
-	for (const auto& [name, val] : vals) {
-		if (selection == val) {
-			preview = name.c_str();
-			break;
-		}
-	}
-	if (ImGui::BeginCombo("##c", preview)) {
-		for (const auto& [name, val] : vals) {
-			const bool selected = selection == val;
-			if (ImGui::Selectable(name.c_str(), selected)) {
-				selection = val;
-				changed = true;
-			}
-			if (selected) {
-				ImGui::SetItemDefaultFocus();
-			}
-		}
-		ImGui::EndCombo();
-	}
-	ImGui::PopID();
-	ImGui::PopID();
-	return changed;
+void SettingsScreen::SetShown(bool shown) {
+	m_shown = shown;
+	m_fetchSettings = true;
+	// the screen drives the renderer directly while open
+	m_governor.SetPaused(shown);
 }
 
-bool SettingsFXAA(RendererSettings* settings) {
-	static const std::vector<std::pair<std::string, RendererSettings::FXAAPreset>> vals = {
-		std::pair("Off", RendererSettings::FXAAPreset::OFF),
-		std::pair("Low", RendererSettings::FXAAPreset::LOW),
-		std::pair("High", RendererSettings::FXAAPreset::HIGH)
-	};
-	return DropdownSetting("FXAA    ", vals, settings->fxaa);
+void SettingsScreen::SetAdaptive(bool enabled) {
+	m_governor.SetEnabled(enabled);
+	EM_ASM({
+		try {
+			localStorage.setItem('adaptiveQuality', $0 ? '1' : '0');
+		} catch (e) {}
+	}, enabled);
 }
-bool SettingsShadows(RendererSettings* settings) {
-	static const std::vector<std::pair<std::string, RendererSettings::ShadowPreset>> vals = {
-		std::pair("Off", RendererSettings::ShadowPreset::OFF),
-		std::pair("Low", RendererSettings::ShadowPreset::LOW),
-		std::pair("Medium", RendererSettings::ShadowPreset::MEDIUM),
-		std::pair("High", RendererSettings::ShadowPreset::HIGH)
-	};
-	return DropdownSetting("Shadows ", vals, settings->shadows);
+void SettingsScreen::Change(Renderer* renderer, Row row, int32_t direction) {
+	switch (row) {
+	case Row::FXAA: StepOption(FXAA_OPTIONS, m_settings->fxaa, direction); break;
+	case Row::Shadows: StepOption(SHADOW_OPTIONS, m_settings->shadows, direction); break;
+	case Row::Outlines: StepOption(OUTLINE_OPTIONS, m_settings->outlines, direction); break;
+	case Row::Adaptive: SetAdaptive(!m_governor.IsEnabled()); break;
+	default: break;
+	}
+	// previewed right away, a step past either end changes nothing and costs nothing
+	RendererConfig::Apply(*renderer, *m_settings);
 }
-bool SettingsOutlines(RendererSettings* settings) {
-	static const std::vector<std::pair<std::string, RendererSettings::OutlinePreset>> vals = {
-		std::pair("Off", RendererSettings::OutlinePreset::OFF),
-		std::pair("On", RendererSettings::OutlinePreset::ON)
-	};
-	return DropdownSetting("Outlines", vals, settings->outlines);
+void SettingsScreen::Save(Renderer* renderer) {
+	*m_settingsOld = *m_settings;
+	RendererConfig::Save(*renderer, *m_settings);
+	m_governor.SetCeiling(*m_settings);
+}
+void SettingsScreen::Close(Renderer* renderer) {
+	*m_settings = *m_settingsOld;
+	RendererConfig::Apply(*renderer, *m_settings);
+	SetShown(false);
 }
 
-void SettingsScreen::SetShown(bool shown) {
-	m_shown = shown;
-	m_fetchSettings = true;
+void SettingsScreen::HandleInput(Renderer* renderer) {
+	if (Input::JustPressed(SDL_SCANCODE_UP)) m_selected = (m_selected + ROW_COUNT - 1) % ROW_COUNT;
+	if (Input::JustPressed(SDL_SCANCODE_DOWN)) m_selected = (m_selected + 1) % ROW_COUNT;
+
+	const Row row = static_cast<Row>(m_selected);
+	if (Input::JustPressed(SDL_SCANCODE_LEFT)) Change(renderer, row, -1);
+	if (Input::JustPressed(SDL_SCANCODE_RIGHT)) Change(renderer, row, 1);
+	if (Input::JustPressed(SDL_SCANCODE_RETURN)) {
+		if (row == Row::Save) Save(renderer);
+		else if (row == Row::Close) Close(renderer);
+		else if (row == Row::Adaptive) Change(renderer, row, 1);
+	}
 }
-void SettingsScreen::Draw(Renderer* renderer) {
+
+void SettingsScreen::AddLine(Scene& scene, std::string_view text, float& y) {
+	const auto drawable = m_textCache.Get("arial-big", text);
+	scene.AddText(drawable);
+	const auto textSize = drawable->GetTextSize() * TEXT_SCALE;
+	drawable->scale = glm::vec3{TEXT_SCALE};
+	drawable->position = {0.5 - textSize.x * 0.5, y - textSize.y, 0.0};
+	drawable->normalizedCoordinates = true;
+	y -= textSize.y + LINE_SPACING;
+}
+
+void SettingsScreen::Draw(Renderer* renderer, Scene& scene) {
 	if (!m_shown) return;
 	if (m_fetchSettings) {
 		m_fetchSettings = false;
-		*m_settings = renderer->GetSettings();
+		// the governor may be below the saved preset, edit the preset itself
+		*m_settings = m_governor.GetCeiling();
 		*m_settingsOld = *m_settings;
+		m_highlightId = Highlights::GetHighlightId("white");
+		m_selectedHighlightId = Highlights::GetHighlightId("yellow");
+		RendererConfig::Apply(*renderer, *m_settings);
 	}
- 	
-	ImGui::PushStyleColor(ImGuiCol_WindowBg, ImVec4{0, 0, 0, 0.8f});
-	const auto& io = ImGui::GetIO();
-	ImGui::SetNextWindowSize(io.DisplaySize);
-	ImGui::SetNextWindowPos({0, 0});
-	if (ImGui::Begin("SettingsBackground", nullptr, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoMove |
-		ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoResize)) {
-		ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f),
-			ImGuiCond_Always, ImVec2(0.5f, 0.5f));
-		if (ImGui::BeginChild(1, {0, 0}, ImGuiChildFlags_AlwaysAutoResize |
-			ImGuiChildFlags_AutoResizeX | ImGuiChildFlags_AutoResizeY,
-			ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoDecoration |
-			ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoBackground)) {
-			SettingsFXAA(m_settings);
-			SettingsShadows(m_settings);
-			SettingsOutlines(m_settings);
-			renderer->SetSettings(*m_settings, false);
-
-			if (ImGui::Button("Save")) {
-				*m_settingsOld = *m_settings;
-				renderer->SetSettings(*m_settings, true);
-			}
-			ImGui::SameLine();
-			if (ImGui::Button("Close")) {
-				*m_settings = *m_settingsOld;
-				renderer->SetSettings(*m_settings, false);
-				m_shown = false;
-			}
+
+	HandleInput(renderer);
+	if (!m_shown) return;
+
+	MemoryTagScope scope(MemoryTag::Text);
+	float y = 0.75f;
+	m_line.clear();
+	std::format_to(std::back_inserter(m_line), "$<{}>Settings", m_highlightId);
+	AddLine(scene, m_line, y);
+	y -= LINE_SPACING;
+
+	for (uint32_t i = 0; i < ROW_COUNT; i++) {
+		const Row row = static_cast<Row>(i);
+		const bool selected = i == m_selected;
+		m_line.clear();
+		std::format_to(std::back_inserter(m_line), "$<{}>{}", selected ? m_selectedHighlightId : m_highlightId,
+			selected ? "> " : "");
+		switch (row) {
+		case Row::FXAA: std::format_to(std::back_inserter(m_line), "FXAA: {}", GetOptionName(FXAA_OPTIONS, m_settings->fxaa)); break;
+		case Row::Shadows: std::format_to(std::back_inserter(m_line), "Shadows: {}", GetOptionName(SHADOW_OPTIONS, m_settings->shadows)); break;
+		case Row::Outlines: std::format_to(std::back_inserter(m_line), "Outlines: {}", GetOptionName(OUTLINE_OPTIONS, m_settings->outlines)); break;
+		case Row::Adaptive: std::format_to(std::back_inserter(m_line), "Adaptive quality: {}", m_governor.IsEnabled() ? "On" : "Off"); break;
+		case Row::Save: m_line += "Save"; break;
+		case Row::Close: m_line += "Close"; break;
+		default: break;
 		}
-		ImGui::EndChild();
+		AddLine(scene, m_line, y);
+	}
+
+	y -= LINE_SPACING;
+	if (m_governor.IsEnabled()) {
+		m_line.clear();
+		std::format_to(std::back_inserter(m_line), "$<{}>level {}/{}, p90 {:.1f} ms", m_highlightId,
+			m_governor.GetLevel() + 1, m_governor.GetLevelCount(), m_governor.GetFrameTimeP90());
+		AddLine(scene, m_line, y);
+	}
+	const RendererConfig::Report& report = RendererConfig::GetLastReport();
+	if (report.changes != RendererConfig::NONE) {
+		m_line.clear();
+		std::format_to(std::back_inserter(m_line), "$<{}>last change ({}) {:.1f} ms", m_highlightId,
+			RendererConfig::DescribeChanges(report.changes), report.ms);
+		AddLine(scene, m_line, y);
 	}
-	ImGui::End();
-	ImGui::PopStyleColor();
+	m_line.clear();
+	std::format_to(std::back_inserter(m_line), "$<{}>arrows - change, enter - select", m_highlightId);
+	AddLine(scene, m_line, y);
+	m_textCache.EndFrame();
 }
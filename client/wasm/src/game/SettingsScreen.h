@@ -1,10 +1,18 @@
 #pragma once
 
+#include <stdint.h>
+#include <string>
+
+#include "util/TextCache.h"
+
+class QualityGovernor;
 class Renderer;
 struct RendererSettings;
+// settings menu drawn with engine text, so release builds need no ImGui.
+// up/down select a row, left/right change it, enter toggles or activates it
 class SettingsScreen {
 public:
-	SettingsScreen();
+	SettingsScreen(QualityGovernor& governor);
 	~SettingsScreen();
 	SettingsScreen(const SettingsScreen&) = delete;
 	SettingsScreen& operator=(const SettingsScreen&) = delete;
@@ -13,11 +21,37 @@ public:
 
 	void SetShown(bool shown);
 	bool IsShown() const { return m_shown; }
-	void Draw(Renderer* renderer);
+	void Draw(Renderer* renderer, Scene& scene);
 
 private:
+	enum class Row : uint8_t {
+		FXAA,
+		Shadows,
+		Outlines,
+		Adaptive,
+		Save,
+		Close,
+		RowCount,
+	};
+	static constexpr uint32_t ROW_COUNT = static_cast<uint32_t>(Row::RowCount);
+
+	void HandleInput(Renderer* renderer);
+	void Change(Renderer* renderer, Row row, int32_t direction);
+	void Save(Renderer* renderer);
+	void Close(Renderer* renderer);
+	void SetAdaptive(bool enabled);
+	// centered line, rows go top to bottom
+	void AddLine(Scene& scene, std::string_view text, float& y);
+
+	QualityGovernor& m_governor;
 	bool m_shown = false;
 	bool m_fetchSettings = true;
 	RendererSettings* m_settings = nullptr;
 	RendererSettings* m_settingsOld = nullptr;
-};
\ No newline at end of file
+
+	uint32_t m_selected = 0;
+	uint8_t m_highlightId = 0;
+	uint8_t m_selectedHighlightId = 0;
+	std::string m_line;
+	TextCache m_textCache;
+};
@@ -0,0 +1,96 @@
+#include "StressScene.h"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <random>
+
+#include "ModelInit.h"
+
+namespace {
+	using State = SceneBuilder::State;
+
+	constexpr float ROOM_SIZE = 120.0f;
+	constexpr uint32_t SHELVES_PER_ROOM = 4;
+	// books lie on the table in layers of 4x2
+	constexpr uint32_t BOOKS_PER_LAYER = 8;
+
+	// looked up by name, a reordered model list still generates the same scene
+	struct Models {
+		int32_t candle = GetModelIndex("candle");
+		int32_t closedBook = GetModelIndex("closedBook");
+		int32_t fullBookshelf = GetModelIndex("fullBookshelf");
+		int32_t table = GetModelIndex("table");
+	};
+
+	// the values below are taken from firstmap, only position and yaw change
+	State Floor(const Models& models, float size) {
+		return {{0, -100, 0}, {0, 0, 0}, {size, 100, size}, models.table, {0, 0, 0}, {0, 0, 0}, {1, 1, 1}, "", 16, 0, 0, 1.98f, {1.38f, 0.954f, 0.81f}, 1, 1, 1};
+	}
+	State Bookshelf(const Models& models, const glm::vec3& p, float yaw) {
+		return {{p.x, 19.13f, p.z}, {0, yaw, 0}, {1, 1, 1}, models.fullBookshelf, {0.49f, -1.51f, 1.3f}, {0, 0, 0}, {4, 4, 4}, "", 0, 0, 0, 1, {17.08f, 23.55f, 6.65f}, 1, 1, 1};
+	}
+	State Table(const Models& models, const glm::vec3& p, float yaw) {
+		return {{p.x, 6.04f, p.z}, {0, yaw, 0}, {20, 20, 20}, models.table, {0, -9.1f, 0}, {0, 0, 0}, {1, 1, 1}, "", 1, 0, 1000, 1, {1.38f, 0.5f, 0.84f}, 1, 1, 1};
+	}
+	State Candle(const Models& models, const glm::vec3& p) {
+		return {{p.x, 20.86f, p.z}, {0, 0, 0}, {3, 3, 3}, models.candle, {0, -5, 0}, {0, 0, 0}, {1, 1, 1}, "", 1, 0, 100, 1, {0.68f, 1.59f, 0.68f}, 1, 0.73f, 2.11f};
+	}
+	State Book(const Models& models, const glm::vec3& p, float yaw) {
+		return {{p.x, p.y, p.z}, {90, yaw, 0}, {5, 5, 5}, models.closedBook, {0, 0, -2.24f}, {0, 0, 0}, {1, 1, 1}, "hintBook", 3, 0, 100, 1, {0.36f, 1.04f, 0.66f}, 1, 1, 1};
+	}
+}
+
+std::vector<SceneBuilder::State> GenerateStressScene(const StressSceneParams& params) {
+	const uint32_t rooms = std::max(1u, (params.bookshelves + SHELVES_PER_ROOM - 1) / SHELVES_PER_ROOM);
+	const uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(rooms))));
+	std::mt19937 rng{params.seed};
+	std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+
+	const Models models;
+	std::vector<State> states;
+	states.reserve(1 + params.bookshelves + rooms + params.books + params.candles);
+	states.push_back(Floor(models, std::max(1000.0f, static_cast<float>(side) * ROOM_SIZE)));
+
+	const auto roomCenter = [&](uint32_t room) {
+		const float offset = (static_cast<float>(side) - 1.0f) * 0.5f;
+		return glm::vec3{(static_cast<float>(room % side) - offset) * ROOM_SIZE, 0,
+			(static_cast<float>(room / side) - offset) * ROOM_SIZE};
+	};
+	// off center, the player spawns at the origin
+	const auto tableCenter = [&](uint32_t room) {
+		return roomCenter(room) + glm::vec3{25, 0, 0};
+	};
+
+	for (uint32_t i = 0; i < params.bookshelves; i++) {
+		const glm::vec3 center = roomCenter(i / SHELVES_PER_ROOM);
+		const float half = ROOM_SIZE * 0.5f - 8.0f;
+		switch (i % SHELVES_PER_ROOM) {
+		case 0: states.push_back(Bookshelf(models, center + glm::vec3{0, 0, -half}, 0)); break;
+		case 1: states.push_back(Bookshelf(models, center + glm::vec3{half, 0, 0}, -90)); break;
+		case 2: states.push_back(Bookshelf(models, center + glm::vec3{0, 0, half}, 180)); break;
+		default: states.push_back(Bookshelf(models, center + glm::vec3{-half, 0, 0}, 90)); break;
+		}
+	}
+
+	// books and candles are dealt out round robin, a table goes in every room that gets any
+	const uint32_t furnishedRooms = std::min(rooms, std::max(params.books, params.candles));
+	for (uint32_t room = 0; room < furnishedRooms; room++) {
+		states.push_back(Table(models, tableCenter(room), 0));
+	}
+	for (uint32_t i = 0; i < params.candles; i++) {
+		const uint32_t room = i % furnishedRooms;
+		const float spread = static_cast<float>(i / furnishedRooms % 3) - 1.0f;
+		states.push_back(Candle(models, tableCenter(room) + glm::vec3{spread * 8.0f, 0, 10}));
+	}
+	for (uint32_t i = 0; i < params.books; i++) {
+		const uint32_t room = i % furnishedRooms;
+		const uint32_t slot = i / furnishedRooms;
+		const uint32_t layer = slot / BOOKS_PER_LAYER;
+		const uint32_t column = slot % BOOKS_PER_LAYER;
+		const glm::vec3 onTable{(static_cast<float>(column % 4) - 1.5f) * 9.0f, 17.0f + static_cast<float>(layer) * 2.5f,
+			(static_cast<float>(column / 4) - 0.5f) * 8.0f - 4.0f};
+		states.push_back(Book(models, tableCenter(room) + onTable, jitter(rng) * 20.0f));
+	}
+	return states;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <wgleng/util/SceneBuilder.h>
+
+// generates library-scale scenes for scaling tests. rooms on a grid, each with up to
+// four fullBookshelves along the walls and a table holding candles and pickable
+// hintBook-tagged books. entries are copies of firstmap states, so they load like
+// any saved scene.
+struct StressSceneParams {
+	uint32_t bookshelves = 64;
+	uint32_t books = 64;
+	uint32_t candles = 16;
+	uint32_t seed = 1;
+};
+
+std::vector<SceneBuilder::State> GenerateStressScene(const StressSceneParams& params);
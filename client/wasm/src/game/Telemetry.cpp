@@ -0,0 +1,153 @@
+#include "Telemetry.h"
+
+#include <array>
+#include <emscripten/bind.h>
+#include <emscripten/emscripten.h>
+#include <format>
+#include <string>
+
+#ifndef WASMGAME_SLIM
+#include <wgleng/vendor/imgui/imgui.h>
+#endif
+
+#include "QualityGovernor.h"
+#include "RunLevel.h"
+#include "util/Histogram.h"
+
+namespace {
+	using Telemetry::Timing;
+
+	constexpr size_t TIMING_COUNT = static_cast<size_t>(Timing::TimingCount);
+	constexpr float BATCH_SECONDS = 30.0f;
+	// a missed frame at 60 Hz, and one anyone would notice
+	constexpr float HITCH_MS = 1000.0f / 30.0f;
+	constexpr float SEVERE_HITCH_MS = 100.0f;
+
+	std::array<LogHistogram, TIMING_COUNT> s_batch;
+	// since load, for the overlay
+	std::array<LogHistogram, TIMING_COUNT> s_session;
+	uint32_t s_hitches = 0;
+	uint32_t s_severeHitches = 0;
+	float s_batchSeconds = 0;
+	std::string s_scene = "firstmap";
+	RendererSettings s_settings{};
+	uint32_t s_qualityLevel = 0;
+	RunLevel s_lastLevel = RunLevel::Full;
+
+	void Send() {
+		if (s_batch[static_cast<size_t>(Timing::Frame)].GetCount() == 0) return;
+
+		std::string json = std::format(R"({{"scene":"{}","seconds":{:.1f},"hitches":{},"severeHitches":{},)"
+			R"("fxaa":{},"shadows":{},"outlines":{},"qualityLevel":{},"timings":{{)",
+			s_scene, s_batchSeconds, s_hitches, s_severeHitches,
+			static_cast<uint32_t>(s_settings.fxaa), static_cast<uint32_t>(s_settings.shadows),
+			static_cast<uint32_t>(s_settings.outlines), s_qualityLevel);
+		for (size_t i = 0; i < TIMING_COUNT; i++) {
+			const LogHistogram& histogram = s_batch[i];
+			json += std::format(R"({}"{}":{{"count":{},"mean":{:.3f},"p50":{:.3f},"p95":{:.3f},"p99":{:.3f},"max":{:.3f}}})",
+				i == 0 ? "" : ",", Telemetry::GetTimingName(static_cast<Timing>(i)), histogram.GetCount(), histogram.GetMean(),
+				histogram.GetPercentile(0.5f), histogram.GetPercentile(0.95f), histogram.GetPercentile(0.99f), histogram.GetMax());
+		}
+		json += "}}";
+
+		// one call per batch, the gpu name is looked up once on the js side
+		EM_ASM({
+			if (typeof window['reportTelemetry'] !== 'function') return;
+			if (Module['telemetryGpu'] === undefined) {
+				const info = GLctx && GLctx.getExtension('WEBGL_debug_renderer_info');
+				Module['telemetryGpu'] = info ? GLctx.getParameter(info.UNMASKED_RENDERER_WEBGL) : '';
+			}
+			const batch = JSON.parse(UTF8ToString($0));
+			batch['gpu'] = Module['telemetryGpu'];
+			window['reportTelemetry'](batch);
+		}, json.c_str());
+
+		for (auto& histogram : s_batch) histogram.Clear();
+		s_hitches = 0;
+		s_severeHitches = 0;
+		s_batchSeconds = 0;
+	}
+}
+
+void Telemetry::SetScene(std::string_view scene) {
+	if (s_scene == scene) return;
+	// a batch describes one level
+	Send();
+	s_scene = scene;
+}
+void Telemetry::Record(Timing timing, float ms) {
+	if (RunLevels::Get() != RunLevel::Full) return;
+	s_batch[static_cast<size_t>(timing)].Add(ms);
+	s_session[static_cast<size_t>(timing)].Add(ms);
+}
+
+void Telemetry::Update(TimeDuration dt, const RendererSettings& settings, const QualityGovernor& governor) {
+	const RunLevel level = RunLevels::Get();
+	const bool leftFull = level != RunLevel::Full && s_lastLevel == RunLevel::Full;
+	s_lastLevel = level;
+	// the tab may never come back, send while we can
+	if (leftFull) Send();
+	if (level != RunLevel::Full) return;
+
+	const float ms = dt.fMilli();
+	Record(Timing::Frame, ms);
+	if (ms > HITCH_MS) s_hitches++;
+	if (ms > SEVERE_HITCH_MS) s_severeHitches++;
+	s_batchSeconds += ms / 1000.0f;
+	// the state the frames ran at, the last one of the batch
+	s_settings = settings;
+	s_qualityLevel = governor.GetLevel();
+
+	if (s_batchSeconds >= BATCH_SECONDS) Send();
+}
+void Telemetry::Flush() {
+	Send();
+}
+
+const char* Telemetry::GetTimingName(Timing timing) {
+	switch (timing) {
+	case Timing::Frame: return "frame";
+	case Timing::Update: return "update";
+	case Timing::Physics: return "physics";
+	case Timing::Scripts: return "scripts";
+	default: return "unknown";
+	}
+}
+
+#ifndef WASMGAME_SLIM
+void Telemetry::DrawOverlay() {
+	const auto& io = ImGui::GetIO();
+	ImGui::SetNextWindowPos({io.DisplaySize.x - 10, 10}, ImGuiCond_FirstUseEver, {1, 0});
+	if (ImGui::Begin("Frame pacing", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing)) {
+		ImGui::Text("hitches %u, severe %u this batch", s_hitches, s_severeHitches);
+		if (ImGui::BeginTable("FramePacing", 5, ImGuiTableFlags_SizingFixedFit)) {
+			ImGui::TableSetupColumn("ms");
+			ImGui::TableSetupColumn("p50");
+			ImGui::TableSetupColumn("p95");
+			ImGui::TableSetupColumn("p99");
+			ImGui::TableSetupColumn("max");
+			ImGui::TableHeadersRow();
+			for (size_t i = 0; i < TIMING_COUNT; i++) {
+				const LogHistogram& histogram = s_session[i];
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(GetTimingName(static_cast<Timing>(i)));
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2f", histogram.GetPercentile(0.5f));
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2f", histogram.GetPercentile(0.95f));
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2f", histogram.GetPercentile(0.99f));
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2f", histogram.GetMax());
+			}
+			ImGui::EndTable();
+		}
+	}
+	ImGui::End();
+}
+#endif
+
+EMSCRIPTEN_BINDINGS(telemetry) {
+	emscripten::function("flushTelemetry", &Telemetry::Flush);
+}
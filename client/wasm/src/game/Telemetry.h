@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include <string_view>
+#include <wgleng/rendering/Renderer.h>
+#include <wgleng/util/Timer.h>
+
+class QualityGovernor;
+
+// frame pacing telemetry for production. rolling histograms of frame, update, physics and
+// script time plus hitch counts, summarized in the module and handed to the page as one json
+// batch every 30 s of play (or when the game goes out of view), mode3Page posts it to the backend.
+// only full run level frames count, throttled frames say nothing about the hardware.
+namespace Telemetry {
+	enum class Timing : uint8_t {
+		Frame,   // time between frames
+		Update,  // game update, physics and scripts included
+		Physics, // all fixed steps of the frame
+		Scripts,
+		TimingCount,
+	};
+
+	// the level being played, reported with every batch
+	void SetScene(std::string_view scene);
+	void Record(Timing timing, float ms);
+	// call every tick, closes the frame and sends a batch when one is due
+	void Update(TimeDuration dt, const RendererSettings& settings, const QualityGovernor& governor);
+	// sends what was collected so far, the page calls it when leaving
+	void Flush();
+
+	const char* GetTimingName(Timing timing);
+#ifndef WASMGAME_SLIM
+	// ImGui window shown with the CTRL+U metrics
+	void DrawOverlay();
+#endif
+}
@@ -1,21 +1,31 @@
 #include "ControlHintsScript.h"
 
+#include <format>
+#include <iterator>
 #include <wgleng/rendering/Highlights.h>
 
+#include "../util/MemoryStats.h"
+
 ControlHintsScript::ControlHintsScript(GameScene& scene)
 	: Script(scene) {
 	m_highlightId = Highlights::GetHighlightId("white");
 	scene.SetControlHintHandler([this](std::string_view hint) {
-		m_controlHints.emplace_back(hint);
+		if (m_controlHintCount == m_controlHints.size()) m_controlHints.emplace_back();
+		// highlight prefix is baked in here, the cache compares whole strings
+		std::string& text = m_controlHints[m_controlHintCount++];
+		text.clear();
+		std::format_to(std::back_inserter(text), "$<{}>", m_highlightId);
+		text += hint;
 		});
 }
 
-void ControlHintsScript::Update(TimeDuration dt) {
+void ControlHintsScript::Draw() {
 	constexpr float textScale = 0.025f;
+	MemoryTagScope scope(MemoryTag::Text);
 	m_controlHintTexts.clear();
 	glm::vec2 maxSize{0};
-	for (const auto& hint : m_controlHints) {
-		auto text = Text::CreateText("arial-big", std::format("$<{}>", m_highlightId) + hint);
+	for (uint32_t i = 0; i < m_controlHintCount; i++) {
+		auto text = m_textCache.Get("arial-big", m_controlHints[i]);
 		scene.AddText(text);
 		m_controlHintTexts.push_back(text);
 
@@ -31,5 +41,6 @@ void ControlHintsScript::Update(TimeDuration dt) {
 		currentHeight += maxSize.y + 0.01;
 	}
 
-	m_controlHints.clear();
+	m_controlHintCount = 0;
+	m_textCache.EndFrame();
 }
@@ -4,16 +4,20 @@
 #include <vector>
 
 #include "../Script.h"
+#include "../util/TextCache.h"
 
 class ControlHintsScript : public Script {
 public:
 	ControlHintsScript(GameScene& scene);
 	~ControlHintsScript() override = default;
 
-	void Update(TimeDuration dt) override;
+	void Draw() override;
 
 private:
+	// strings are reused between frames to keep their capacity
 	std::vector<std::string> m_controlHints;
+	uint32_t m_controlHintCount = 0;
 	std::vector<std::shared_ptr<DrawableText>> m_controlHintTexts;
+	TextCache m_textCache;
 	uint8_t m_highlightId = 0;
 };
@@ -17,41 +17,35 @@ HeldObjectScript::HeldObjectScript(GameScene& scene)
 void HeldObjectScript::Update(TimeDuration dt) {
 	auto& player = scene.player;
 
-	entt::entity firstHitEntity = entt::null;
-
-	// raycast for item picking
-	if (player.objectCarry.GetCarriedEntity() == entt::null) {
-		const glm::vec3 rayFrom = player.GetCamera()->position;
-		const glm::vec3 rayTo = rayFrom + player.GetCamera()->GetFront() * 50.0f;
-		const auto hits = scene.GetPhysicsWorld().RaycastWorld(rayFrom, rayTo, true,
-			[&](entt::entity entity, const btRigidBody* body, const glm::vec3& hitPos, const glm::vec3& hitNormal) {
-				if (player.objectCarry.GetCarriedEntity() == entity) return false;
-				const auto& flagComp = scene.registry.get<FlagComponent>(entity);
-				const bool validHit = flagComp.flags & (EntityFlags::PICKABLE);
-				return validHit;
-			});
-
-		// select first entity
-		if (!hits.empty()) {
-			const auto& firstHit = hits.front();
-			firstHitEntity = firstHit.entity;
-			if (const auto meshComp = scene.registry.try_get<MeshComponent>(firstHit.entity)) {
-				meshComp->highlightId = m_highlightId;
-			}
-			scene.AddControlHint("F - pickup");
-		}
+	// item pickup
+	if (m_shouldPickup) {
+		m_shouldPickup = false;
+		if (player.objectCarry.GetCarriedEntity() == entt::null) player.objectCarry.SetCarriedEntity(RaycastPickable());
+		else player.objectCarry.DropCarriedEntity();
 	}
-
-	if (player.objectCarry.GetCarriedEntity() != entt::null) {
+	player.objectCarry.Update(player.GetCamera()->position, player.GetCamera()->GetFront(), scene.physicsSync);
+}
+void HeldObjectScript::Draw() {
+	if (scene.player.objectCarry.GetCarriedEntity() != entt::null) {
 		if (scene.actions.IsEnabled(Action::PickUp)) scene.AddControlHint("F - drop");
 		if (scene.actions.IsEnabled(Action::Throw)) scene.AddControlHint("Q - throw");
+		return;
 	}
 
-	// item pickup
-	if (m_shouldPickup) {
-		m_shouldPickup = false;
-		if (player.objectCarry.GetCarriedEntity() == entt::null) player.objectCarry.SetCarriedEntity(firstHitEntity);
-		else player.objectCarry.DropCarriedEntity();
+	const entt::entity hovered = RaycastPickable();
+	if (hovered == entt::null) return;
+	if (const auto meshComp = scene.registry.try_get<MeshComponent>(hovered)) {
+		meshComp->highlightId = m_highlightId;
 	}
-	player.objectCarry.Update(player.GetCamera()->position, player.GetCamera()->GetFront());
+	scene.AddControlHint("F - pickup");
+}
+entt::entity HeldObjectScript::RaycastPickable() const {
+	const auto& player = scene.player;
+	if (player.objectCarry.GetCarriedEntity() != entt::null) return entt::null;
+
+	const glm::vec3 rayFrom = player.GetCamera()->position;
+	const glm::vec3 rayTo = rayFrom + player.GetCamera()->GetFront() * 50.0f;
+	PhysicsQueries::RayHit hit;
+	if (!scene.physicsQueries.RaycastClosest({rayFrom, rayTo}, EntityFlags::PICKABLE, hit)) return entt::null;
+	return hit.entity;
 }
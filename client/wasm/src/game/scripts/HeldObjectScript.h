@@ -10,8 +10,13 @@ public:
 	~HeldObjectScript() override = default;
 
 	void Update(TimeDuration dt) override;
+	void Draw() override;
+	void Restart() override { m_shouldPickup = false; }
 
 private:
+	// the closest pickable under the crosshair, null while carrying
+	entt::entity RaycastPickable() const;
+
 	GameActions::Listener m_pickupListener;
 	GameActions::Listener m_throwListener;
 	bool m_shouldPickup = false;
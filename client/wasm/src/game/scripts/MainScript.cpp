@@ -24,3 +24,14 @@ void MainScript::Update(TimeDuration dt) {
 		m_scripts[i]->Update(dt);
 	}
 }
+void MainScript::Draw() {
+	// control hints come last, the others add hints while drawing
+	for (const auto& script : m_scripts) {
+		script->Draw();
+	}
+}
+void MainScript::Restart() {
+	for (const auto& script : m_scripts) {
+		script->Restart();
+	}
+}
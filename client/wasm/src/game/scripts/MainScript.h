@@ -11,6 +11,8 @@ public:
 	~MainScript() override = default;
 
 	void Update(TimeDuration dt) override;
+	void Draw() override;
+	void Restart() override;
 
 private:
 	std::vector<std::unique_ptr<Script>> m_scripts;
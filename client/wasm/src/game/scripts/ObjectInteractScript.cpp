@@ -34,7 +34,7 @@ ObjectInteractScript::ObjectInteractScript(GameScene& scene)
 	});
 }
 
-void ObjectInteractScript::Update(TimeDuration dt) {
+void ObjectInteractScript::Draw() {
 	const auto heldObject = scene.player.objectCarry.GetCarriedEntity();
 	if (heldObject != entt::null) {
 		const auto& flagComp = scene.registry.get<FlagComponent>(heldObject);
@@ -47,10 +47,12 @@ void ObjectInteractScript::Update(TimeDuration dt) {
 		}
 	}
 
-	if (m_readingData.reading) {
-		UpdateReading();
-		return;
-	}
+	// the open book follows the camera of the frame
+	if (m_readingData.reading) UpdateReading();
+}
+
+void ObjectInteractScript::Restart() {
+	if (m_readingData.reading) StopReading();
 }
 
 void ObjectInteractScript::StartReading(entt::entity book) {
@@ -73,7 +75,7 @@ void ObjectInteractScript::StartReading(entt::entity book) {
 		.mesh = MeshRegistry::Get("openBook"),
 		.rotation = {90, 90, 0}
 	});
-	m_readingData.fakeBookTransform = &scene.registry.emplace<TransformComponent>(m_readingData.fakeBook, TransformComponent{
+	scene.registry.emplace<TransformComponent>(m_readingData.fakeBook, TransformComponent{
 		.position = {0, 0, 0},
 		.scale = {0.7f, 0.7f, 0.7f}
 	});
@@ -133,17 +135,18 @@ void ObjectInteractScript::StopReading() {
 	scene.actions.Enable(Action::Throw);
 }
 void ObjectInteractScript::UpdateReading() const {
-	if (!m_readingData.fakeBookTransform) return;
+	// components move inside the packed groups, fetch instead of keeping a pointer
+	const auto transform = scene.registry.try_get<TransformComponent>(m_readingData.fakeBook);
+	if (!transform) return;
 
 	// update fake book position
 	const auto& camera = scene.player.GetCamera();
 	if (!camera) return;
 
-	const glm::quat q = glm::conjugate(glm::toQuat(
-		glm::lookAt(glm::vec3{0}, camera->GetFront(), camera->GetUp())
-	));
+	// face the camera, same as the inverse of its view rotation
+	const glm::quat q = glm::quatLookAt(camera->GetFront(), camera->GetUp());
 	const glm::vec3 rot = glm::degrees(glm::eulerAngles(q));
 
-	m_readingData.fakeBookTransform->position = camera->position + camera->GetFront() * 1.5f;
-	m_readingData.fakeBookTransform->rotation = rot;
+	transform->position = camera->position + camera->GetFront() * 1.5f;
+	transform->rotation = rot;
 }
@@ -2,13 +2,13 @@
 
 #include "../Script.h"
 
-struct TransformComponent;
 class ObjectInteractScript : public Script {
 public:
 	ObjectInteractScript(GameScene& scene);
 	~ObjectInteractScript() override = default;
 
-	void Update(TimeDuration dt) override;
+	void Draw() override;
+	void Restart() override;
 
 private:
 	GameActions::Listener m_listener;
@@ -17,7 +17,6 @@ private:
 		bool reading{ false };
 		entt::entity realBook{ entt::null };
 		entt::entity fakeBook{ entt::null };
-		TransformComponent* fakeBookTransform{ nullptr };
 	} m_readingData;
 	void StartReading(entt::entity book);
 	void StopReading();
@@ -2,16 +2,18 @@
 
 #include <emscripten/bind.h>
 #include <emscripten/emscripten.h>
+#include <format>
 #include <functional>
 #include <string>
 #include <vector>
 #include <wgleng/core/Components.h>
+#include <wgleng/core/PhysicsWorld.h>
 #include <wgleng/rendering/Highlights.h>
 #include <wgleng/util/Timer.h>
 
 #include "../GameComponents.h"
+#include "../util/MemoryStats.h"
 
-TimePoint lastCheckTime;
 std::function<void(bool)> checkDoorCodeCallback;
 void checkDoorCodeResponse(bool success) {
 	checkDoorCodeCallback(success);
@@ -39,29 +41,34 @@ SecretDoorScript::SecretDoorScript(GameScene& scene)
 		Win();
 	});
 
+	// the server accepted the code, also replayed from the input log
+	m_openDoorListener = scene.actions.Listen(Action::OpenSecretDoor, [&] {
+		// hidden instead of destroyed, like a book being read, so a restart can bring them back
+		for (auto&& [entity, tagComp] : scene.registry.view<TagComponent>().each()) {
+			if (tagComp.tag != "secretDoor" && tagComp.tag != "codeEnter") continue;
+			if (const auto meshComp = scene.registry.try_get<MeshComponent>(entity)) {
+				meshComp->hiddenPersistent = true;
+			}
+			if (scene.registry.all_of<FlagComponent>(entity)) {
+				scene.registry.patch<FlagComponent>(entity, [](FlagComponent& flagComp) {
+					flagComp.flags &= ~EntityFlags::INTERACTABLE;
+					flagComp.flags |= EntityFlags::DISABLE_COLLISIONS;
+				});
+			}
+			if (const auto rbComp = scene.registry.try_get<RigidBodyComponent>(entity); rbComp && rbComp->body) {
+				PhysicsWorld::BodyDisableCollisions(rbComp->body);
+			}
+		}
+	});
+
 	// listen for interact action
-	lastCheckTime = TimePoint();
 	m_listener = scene.actions.Listen(Action::Interact, [&] {
 		const auto& player = scene.player;
 		if (player.objectCarry.GetCarriedEntity() != entt::null) return;
 
-		const glm::vec3 rayFrom = player.GetCamera()->position;
-		const glm::vec3 rayTo = rayFrom + player.GetCamera()->GetFront() * 50.0f;
-		const auto hits = scene.GetPhysicsWorld().RaycastWorld(rayFrom, rayTo, true,
-			[&](entt::entity entity, const btRigidBody* body, const glm::vec3& hitPos, const glm::vec3& hitNormal) {
-				const auto tagComp = scene.registry.try_get<TagComponent>(entity);
-				if (!tagComp) return false;
-
-				const auto& flagComp = scene.registry.get<FlagComponent>(entity);
-				const bool validHit = flagComp.flags & EntityFlags::INTERACTABLE;
-				return validHit;
-			});
+		const auto firstHitEntity = RaycastInteractable();
+		if (firstHitEntity == entt::null) return;
 
-		// select first entity
-		if (hits.empty()) return;
-
-		const auto& firstHit = hits.front();
-		const auto firstHitEntity = firstHit.entity;
 		const auto tagComp = scene.registry.try_get<TagComponent>(firstHitEntity);
 		if (!tagComp) return;
 
@@ -71,21 +78,19 @@ SecretDoorScript::SecretDoorScript(GameScene& scene)
 
 		// secret door stuff
 		if (tagComp->tag == "codeEnter") {
-			if (TimePoint() - lastCheckTime < 1s) return;
-
-			lastCheckTime = TimePoint();
-			checkDoorCodeCallback = [&](bool success) {
-				if (!success) return;
-				for (auto&& [entity, tagComp] : scene.registry.view<TagComponent>().each()) {
-					if (tagComp.tag == "secretDoor" || tagComp.tag == "codeEnter") {
-						scene.registry.destroy(entity);
-					}
-				}
-			};
-
-			EM_ASM({
-				checkDoorCode(UTF8ToString($0));
-				}, m_enteredCode.c_str());
+			if (scene.GetPlayTime() - m_lastCheckTime < 1.0f) return;
+
+			m_lastCheckTime = scene.GetPlayTime();
+			// a replay takes the answer from the log instead of asking again, and like any offline
+			// scene leaves the global callback to the live one
+			if (!scene.IsOffline()) {
+				checkDoorCodeCallback = [&](bool success) {
+					if (success) scene.ExternalEvent(InputEvent::DoorOpened);
+				};
+				EM_ASM({
+					checkDoorCode(UTF8ToString($0));
+					}, m_enteredCode.c_str());
+			}
 			m_enteredCode.clear();
 			return;
 		}
@@ -112,18 +117,21 @@ void SecretDoorScript::Update(TimeDuration dt) {
                 bookHintCount++;
             }
         }
-        setBookHintsCallback = [&](std::vector<std::string> hints) {
-            int bookHintIndex = 0;
-            for (auto&& [entity, tagComp] : scene.registry.view<TagComponent>().each()) {
-                if (tagComp.tag != "hintBook") continue;
-                if (bookHintIndex >= hints.size()) break;
-                scene.registry.emplace<BookHintComponent>(entity, BookHintComponent{hints[bookHintIndex]});
-                bookHintIndex++;
-            }
-        };
-        EM_ASM({
-            getBookHints($0);
-            }, bookHintCount);
+        // the callback is global, an offline scene must not take it from the live one
+        if (!scene.IsOffline()) {
+            setBookHintsCallback = [&](std::vector<std::string> hints) {
+                int bookHintIndex = 0;
+                for (auto&& [entity, tagComp] : scene.registry.view<TagComponent>().each()) {
+                    if (tagComp.tag != "hintBook") continue;
+                    if (bookHintIndex >= hints.size()) break;
+                    scene.registry.emplace<BookHintComponent>(entity, BookHintComponent{hints[bookHintIndex]});
+                    bookHintIndex++;
+                }
+            };
+            EM_ASM({
+                getBookHints($0);
+                }, bookHintCount);
+        }
 
         // add golden book component
         for (auto&& [entity, tagComp] : scene.registry.view<TagComponent>().each()) {
@@ -133,6 +141,10 @@ void SecretDoorScript::Update(TimeDuration dt) {
         }
     }
 
+    // the timer stops on the step of the win
+    if (!m_won) m_endTime = scene.GetPlayTime();
+}
+void SecretDoorScript::Draw() {
     // highlight golden book
     for (auto&& [entity, gbComp, meshComp] : scene.registry.view<GoldenBookComponent, MeshComponent>().each()) {
         meshComp.highlightId = m_goldenHighlightId;
@@ -141,23 +153,12 @@ void SecretDoorScript::Update(TimeDuration dt) {
     // highlight interactable objects
     const auto& player = scene.player;
     if (player.objectCarry.GetCarriedEntity() == entt::null) {
-        const glm::vec3 rayFrom = player.GetCamera()->position;
-        const glm::vec3 rayTo = rayFrom + player.GetCamera()->GetFront() * 50.0f;
-        const auto hits = scene.GetPhysicsWorld().RaycastWorld(rayFrom, rayTo, true,
-            [&](entt::entity entity, const btRigidBody* body, const glm::vec3& hitPos, const glm::vec3& hitNormal) {
-                const auto tagComp = scene.registry.try_get<TagComponent>(entity);
-                if (!tagComp) return false;
-
-                const auto& flagComp = scene.registry.get<FlagComponent>(entity);
-                const bool validHit = flagComp.flags & EntityFlags::INTERACTABLE;
-                return validHit;
-            });
-        if (!hits.empty()) {
-            const auto& firstHit = hits.front();
-            if (const auto meshComp = scene.registry.try_get<MeshComponent>(firstHit.entity)) {
+        const auto firstHitEntity = RaycastInteractable();
+        if (firstHitEntity != entt::null) {
+            if (const auto meshComp = scene.registry.try_get<MeshComponent>(firstHitEntity)) {
                 meshComp->highlightId = m_highlightId;
             }
-			const auto tagComp = scene.registry.try_get<TagComponent>(firstHit.entity);
+			const auto tagComp = scene.registry.try_get<TagComponent>(firstHitEntity);
 			if (tagComp) {
 				if (tagComp->tag == "code1") scene.AddControlHint("E - enter 1");
 				else if (tagComp->tag == "code2") scene.AddControlHint("E - enter 2");
@@ -168,21 +169,55 @@ void SecretDoorScript::Update(TimeDuration dt) {
     }
 
     // display timer
-    if (!m_won) m_endTime = TimePoint();
-    const TimeDuration dur = m_endTime - m_startTime;
-	const std::string timerText = std::format("$<{}>{:02d}:{:02d}", m_highlightId, dur.iSec() / 60, dur.iSec() % 60);
-    m_timerText = Text::CreateText("arial-big", timerText);
+    MemoryTagScope textScope(MemoryTag::Text);
+    const int32_t seconds = static_cast<int32_t>(m_endTime - m_startTime);
+	// formatted on the stack, the cache only builds a new text once a second
+	char timerText[32];
+	const auto result = std::format_to_n(timerText, sizeof(timerText), "$<{}>{:02d}:{:02d}", m_highlightId,
+		seconds / 60, seconds % 60);
+	m_timerText = m_textCache.Get("arial-big", std::string_view(timerText, result.out));
     scene.AddText(m_timerText);
+    // each timer string is shown for one second only, no point keeping old ones
+    m_textCache.EndFrame(1);
 
 	const auto textSize = m_timerText->GetTextSize() * 0.035f;
     m_timerText->scale = glm::vec3{0.035};
     m_timerText->position = {0.5 - textSize.x * 0.5, 1.0 - textSize.y, 0.0};
 	m_timerText->normalizedCoordinates = true;
 }
+entt::entity SecretDoorScript::RaycastInteractable() const {
+	const auto& player = scene.player;
+	const glm::vec3 rayFrom = player.GetCamera()->position;
+	const glm::vec3 rayTo = rayFrom + player.GetCamera()->GetFront() * 50.0f;
+
+	// untagged interactables are skipped, so look a few hits deep
+	PhysicsQueries::RayHit hits[4];
+	const uint32_t count = scene.physicsQueries.RaycastAll({rayFrom, rayTo}, EntityFlags::INTERACTABLE, hits);
+	for (uint32_t i = 0; i < count; i++) {
+		if (scene.registry.all_of<TagComponent>(hits[i].entity)) return hits[i].entity;
+	}
+	return entt::null;
+}
+void SecretDoorScript::Restart() {
+	m_won = false;
+	m_startTime = scene.GetPlayTime();
+	m_endTime = m_startTime;
+	m_lastCheckTime = m_startTime;
+	m_enteredCode.clear();
+}
 void SecretDoorScript::Win() {
 	if (m_won) return;
 	m_won = true;
+	// the win can come from an action before this step's Update, take the time of this step
+	m_endTime = scene.GetPlayTime();
+	const auto seconds = static_cast<int32_t>(m_endTime - m_startTime);
+	if (!scene.FinishRun(seconds)) return;
+	// the task is scored on the first level, later rooms are only played
+	if (&scene.GetLevel() != &Levels::GetFirst()) return;
+	// the log goes with the score. the server only checks it is consistent with the time,
+	// it can not re-simulate it, so this is no proof against a forged log
+	const std::string inputLog = scene.GetInputLog().EncodeBase64();
 	EM_ASM({
-		winGame($0);
-	}, static_cast<int32_t>((m_endTime - m_startTime).iSec()));
+		winGame($0, UTF8ToString($1));
+	}, seconds, inputLog.c_str());
 }
@@ -5,6 +5,7 @@
 #include <wgleng/util/Timer.h>
 
 #include "../Script.h"
+#include "../util/TextCache.h"
 
 class SecretDoorScript : public Script {
 public:
@@ -12,16 +13,26 @@ public:
 	~SecretDoorScript() override = default;
 
 	void Update(TimeDuration dt) override;
+	void Draw() override;
+	// restarts the timer, book hints stay
+	void Restart() override;
 
 private:
 	void Win();
+	// nearest tagged interactable under the crosshair
+	entt::entity RaycastInteractable() const;
 
 	bool m_won = false;
-	TimePoint m_startTime{};
-	TimePoint m_endTime{};
+	// play time of the scene, pauses with it
+	float m_startTime = 0;
+	float m_endTime = 0;
+	// play time too, wall clock would not replay
+	float m_lastCheckTime = 0;
 	std::shared_ptr<DrawableText> m_timerText;
+	TextCache m_textCache;
 	GameActions::Listener m_listener;
 	GameActions::Listener m_winGameListener;
+	GameActions::Listener m_openDoorListener;
 	std::string m_enteredCode;
 	uint8_t m_highlightId = 0;
 	uint8_t m_goldenHighlightId = 0;
@@ -0,0 +1,292 @@
+#include "PhysicsQueries.h"
+
+#include <LinearMath/btAabbUtil2.h>
+
+#include "PhysicsSync.h"
+
+namespace {
+	constexpr int QUERY_FILTERS = PhysicsQueries::PICKABLE_FILTER | PhysicsQueries::INTERACTABLE_FILTER;
+
+	// rejects bodies without the queried flags on their filter group, before bullet tests their shape
+	struct QueryCallback : btCollisionWorld::RayResultCallback {
+		entt::entity ignore;
+		// body the shape test runs on, set right before it
+		const PhysicsQueries::Tracked* current = nullptr;
+
+		QueryCallback(PhysicsQueries::FlagMask mask, entt::entity ignore) : ignore(ignore) {
+			m_collisionFilterMask = PhysicsQueries::FilterGroups(mask);
+		}
+
+		bool needsCollision(btBroadphaseProxy* proxy) const override {
+			if (!(proxy->m_collisionFilterGroup & m_collisionFilterMask)) return false;
+			return static_cast<const PhysicsQueries::Tracked*>(proxy->m_clientObject)->entity != ignore;
+		}
+
+		static btVector3 WorldNormal(const btCollisionWorld::LocalRayResult& result, bool normalInWorldSpace) {
+			if (normalInWorldSpace) return result.m_hitNormalLocal;
+			return result.m_collisionObject->getWorldTransform().getBasis() * result.m_hitNormalLocal;
+		}
+		void TestBody(const PhysicsQueries::Tracked& tracked, const btTransform& from, const btTransform& to) {
+			current = &tracked;
+			btCollisionWorld::rayTestSingle(from, to, tracked.body, tracked.body->getCollisionShape(),
+				tracked.body->getWorldTransform(), *this);
+		}
+	};
+
+	struct ClosestCallback final : QueryCallback {
+		using QueryCallback::QueryCallback;
+
+		entt::entity entity = entt::null;
+		btVector3 normal;
+
+		btScalar addSingleResult(btCollisionWorld::LocalRayResult& result, bool normalInWorldSpace) override {
+			m_closestHitFraction = result.m_hitFraction;
+			m_collisionObject = result.m_collisionObject;
+			entity = current->entity;
+			normal = WorldNormal(result, normalInWorldSpace);
+			return result.m_hitFraction;
+		}
+	};
+
+	// keeps the nearest hits.size() entities sorted, nothing is allocated
+	struct CollectCallback final : QueryCallback {
+		std::span<PhysicsQueries::RayHit> hits;
+		uint32_t count = 0;
+
+		CollectCallback(PhysicsQueries::FlagMask mask, entt::entity ignore, std::span<PhysicsQueries::RayHit> hits)
+			: QueryCallback(mask, ignore), hits(hits) {}
+
+		btScalar addSingleResult(btCollisionWorld::LocalRayResult& result, bool normalInWorldSpace) override {
+			const entt::entity entity = current->entity;
+			const float fraction = result.m_hitFraction;
+			// concave shapes report several triangles
+			uint32_t pos = count;
+			for (uint32_t i = 0; i < count; i++) {
+				if (hits[i].entity != entity) continue;
+				if (hits[i].fraction <= fraction) return m_closestHitFraction;
+				pos = i;
+				break;
+			}
+			if (pos == count) {
+				if (count == hits.size() && hits[count - 1].fraction <= fraction) return m_closestHitFraction;
+				if (count < hits.size()) count++;
+				pos = count - 1;
+			}
+			while (pos > 0 && hits[pos - 1].fraction > fraction) {
+				hits[pos] = hits[pos - 1];
+				pos--;
+			}
+			const btVector3 normal = WorldNormal(result, normalInWorldSpace);
+			hits[pos].entity = entity;
+			hits[pos].normal = {normal.x(), normal.y(), normal.z()};
+			hits[pos].fraction = fraction;
+			m_collisionObject = result.m_collisionObject;
+			// once full, farther bodies can be skipped
+			if (count == hits.size()) m_closestHitFraction = hits[count - 1].fraction;
+			return m_closestHitFraction;
+		}
+	};
+
+	// walks the proxies along one ray, like btCollisionWorld::rayTest does for the whole world
+	struct RayWalker final : btBroadphaseRayCallback {
+		btTransform from;
+		btTransform to;
+		QueryCallback& result;
+
+		RayWalker(const btVector3& rayFrom, const btVector3& rayTo, QueryCallback& result) : result(result) {
+			from.setIdentity();
+			from.setOrigin(rayFrom);
+			to.setIdentity();
+			to.setOrigin(rayTo);
+			const btVector3 direction = (rayTo - rayFrom).normalized();
+			for (int i = 0; i < 3; i++) {
+				m_rayDirectionInverse[i] = direction[i] == btScalar(0) ? btScalar(BT_LARGE_FLOAT) : 1 / direction[i];
+				m_signs[i] = m_rayDirectionInverse[i] < 0;
+			}
+			m_lambda_max = direction.dot(rayTo - rayFrom);
+		}
+
+		bool process(const btBroadphaseProxy* proxy) override {
+			if (result.m_closestHitFraction == btScalar(0)) return false;
+			auto* candidate = const_cast<btBroadphaseProxy*>(proxy);
+			if (result.needsCollision(candidate)) {
+				result.TestBody(*static_cast<const PhysicsQueries::Tracked*>(proxy->m_clientObject), from, to);
+			}
+			return true;
+		}
+	};
+
+	// matching proxies in the bounds of a batch
+	struct BoundsCollector final : btBroadphaseAabbCallback {
+		int filter;
+		std::vector<const PhysicsQueries::Tracked*>& candidates;
+
+		BoundsCollector(int filter, std::vector<const PhysicsQueries::Tracked*>& candidates)
+			: filter(filter), candidates(candidates) {}
+
+		bool process(const btBroadphaseProxy* proxy) override {
+			if (proxy->m_collisionFilterGroup & filter) {
+				candidates.push_back(static_cast<const PhysicsQueries::Tracked*>(proxy->m_clientObject));
+			}
+			return true;
+		}
+	};
+
+	btVector3 ToBt(const glm::vec3& v) {
+		return {v.x, v.y, v.z};
+	}
+	// a ray without length has no direction to walk
+	bool IsEmpty(const PhysicsQueries::Ray& ray) {
+		return ray.from == ray.to;
+	}
+	void SetEngineFilterGroups(btCollisionObject* body, int groups) {
+		btBroadphaseProxy* handle = body->getBroadphaseHandle();
+		if (!handle) return;
+		handle->m_collisionFilterGroup = (handle->m_collisionFilterGroup & ~QUERY_FILTERS) | groups;
+	}
+}
+
+int PhysicsQueries::FilterGroups(FlagMask flags) {
+	int groups = 0;
+	if (flags & EntityFlags::PICKABLE) groups |= PICKABLE_FILTER;
+	if (flags & EntityFlags::INTERACTABLE) groups |= INTERACTABLE_FILTER;
+	return groups;
+}
+
+PhysicsQueries::PhysicsQueries(entt::registry& registry) : m_registry(registry) {
+	m_registry.on_construct<FlagComponent>().connect<&PhysicsQueries::OnChanged>(*this);
+	m_registry.on_update<FlagComponent>().connect<&PhysicsQueries::OnChanged>(*this);
+	m_registry.on_destroy<FlagComponent>().connect<&PhysicsQueries::OnDestroy>(*this);
+	m_registry.on_construct<RigidBodyComponent>().connect<&PhysicsQueries::OnChanged>(*this);
+	m_registry.on_update<RigidBodyComponent>().connect<&PhysicsQueries::OnChanged>(*this);
+	m_registry.on_destroy<RigidBodyComponent>().connect<&PhysicsQueries::OnDestroy>(*this);
+
+	for (const auto entity : m_registry.view<RigidBodyComponent, FlagComponent>()) {
+		OnChanged(m_registry, entity);
+	}
+}
+PhysicsQueries::~PhysicsQueries() {
+	m_registry.on_construct<FlagComponent>().disconnect<&PhysicsQueries::OnChanged>(*this);
+	m_registry.on_update<FlagComponent>().disconnect<&PhysicsQueries::OnChanged>(*this);
+	m_registry.on_destroy<FlagComponent>().disconnect<&PhysicsQueries::OnDestroy>(*this);
+	m_registry.on_construct<RigidBodyComponent>().disconnect<&PhysicsQueries::OnChanged>(*this);
+	m_registry.on_update<RigidBodyComponent>().disconnect<&PhysicsQueries::OnChanged>(*this);
+	m_registry.on_destroy<RigidBodyComponent>().disconnect<&PhysicsQueries::OnDestroy>(*this);
+
+	// the broadphase frees its tree but not the proxies in it
+	for (const auto& tracked : m_tracked) {
+		if (tracked) m_broadphase.destroyProxy(tracked->proxy, nullptr);
+	}
+}
+
+void PhysicsQueries::OnChanged(entt::registry& registry, entt::entity entity) {
+	Untrack(entity);
+	const auto* flagComp = registry.try_get<FlagComponent>(entity);
+	const auto* rbComp = registry.try_get<RigidBodyComponent>(entity);
+	if (!flagComp || !rbComp || !rbComp->body) return;
+	const int groups = FilterGroups(flagComp->flags & QUERY_FLAGS);
+	SetEngineFilterGroups(rbComp->body, groups);
+	if (!groups) return;
+
+	auto tracked = std::make_unique<Tracked>(Tracked{entity, rbComp->body, nullptr});
+	btVector3 aabbMin, aabbMax;
+	tracked->body->getCollisionShape()->getAabb(tracked->body->getWorldTransform(), aabbMin, aabbMax);
+	// mask 0, the proxies never pair with each other
+	tracked->proxy = m_broadphase.createProxy(aabbMin, aabbMax, tracked->body->getCollisionShape()->getShapeType(),
+		tracked.get(), groups, 0, nullptr);
+
+	const auto index = static_cast<uint32_t>(entt::to_entity(entity));
+	if (index >= m_tracked.size()) m_tracked.resize(index + 1);
+	m_tracked[index] = std::move(tracked);
+}
+void PhysicsQueries::OnDestroy(entt::registry& registry, entt::entity entity) {
+	Untrack(entity);
+}
+void PhysicsQueries::Untrack(entt::entity entity) {
+	const auto index = static_cast<uint32_t>(entt::to_entity(entity));
+	if (index >= m_tracked.size() || !m_tracked[index]) return;
+	// only the own proxy goes, the body is not touched
+	m_broadphase.destroyProxy(m_tracked[index]->proxy, nullptr);
+	m_tracked[index].reset();
+}
+void PhysicsQueries::UpdateBounds(const Tracked& tracked) {
+	btVector3 aabbMin, aabbMax;
+	tracked.body->getCollisionShape()->getAabb(tracked.body->getWorldTransform(), aabbMin, aabbMax);
+	m_broadphase.setAabb(tracked.proxy, aabbMin, aabbMax, nullptr);
+}
+
+void PhysicsQueries::Update(const PhysicsSync& physicsSync) {
+	for (const auto& moved : physicsSync.GetMoved()) {
+		const auto index = static_cast<uint32_t>(entt::to_entity(moved.entity));
+		if (index < m_tracked.size() && m_tracked[index]) UpdateBounds(*m_tracked[index]);
+	}
+}
+void PhysicsQueries::Refresh() {
+	for (const auto& tracked : m_tracked) {
+		if (tracked) UpdateBounds(*tracked);
+	}
+}
+
+bool PhysicsQueries::RaycastClosest(const Ray& ray, FlagMask mask, RayHit& hit, entt::entity ignore) const {
+	if (IsEmpty(ray)) return false;
+	ClosestCallback callback(mask, ignore);
+	RayWalker walker(ToBt(ray.from), ToBt(ray.to), callback);
+	m_broadphase.rayTest(ToBt(ray.from), ToBt(ray.to), walker);
+	if (callback.entity == entt::null) return false;
+
+	hit.entity = callback.entity;
+	hit.fraction = callback.m_closestHitFraction;
+	hit.position = glm::mix(ray.from, ray.to, hit.fraction);
+	hit.normal = {callback.normal.x(), callback.normal.y(), callback.normal.z()};
+	return true;
+}
+uint32_t PhysicsQueries::RaycastAll(const Ray& ray, FlagMask mask, std::span<RayHit> hits, entt::entity ignore) const {
+	if (hits.empty() || IsEmpty(ray)) return 0;
+	CollectCallback callback(mask, ignore, hits);
+	RayWalker walker(ToBt(ray.from), ToBt(ray.to), callback);
+	m_broadphase.rayTest(ToBt(ray.from), ToBt(ray.to), walker);
+	for (uint32_t i = 0; i < callback.count; i++) {
+		hits[i].position = glm::mix(ray.from, ray.to, hits[i].fraction);
+	}
+	return callback.count;
+}
+void PhysicsQueries::RaycastClosestBatch(std::span<const Ray> rays, FlagMask mask, std::span<RayHit> hits) const {
+	if (rays.empty()) return;
+
+	// one walk of the tree for the bounds of every ray
+	glm::vec3 boundsMin = glm::min(rays[0].from, rays[0].to);
+	glm::vec3 boundsMax = glm::max(rays[0].from, rays[0].to);
+	for (const Ray& ray : rays) {
+		boundsMin = glm::min(boundsMin, glm::min(ray.from, ray.to));
+		boundsMax = glm::max(boundsMax, glm::max(ray.from, ray.to));
+	}
+	m_candidates.clear();
+	BoundsCollector collector(FilterGroups(mask), m_candidates);
+	m_broadphase.aabbTest(ToBt(boundsMin), ToBt(boundsMax), collector);
+
+	// then each ray against the candidates whose bounds it crosses before its closest hit so far
+	for (size_t i = 0; i < rays.size(); i++) {
+		hits[i] = {};
+		const btVector3 from = ToBt(rays[i].from);
+		const btVector3 to = ToBt(rays[i].to);
+		btTransform fromTransform, toTransform;
+		fromTransform.setIdentity();
+		fromTransform.setOrigin(from);
+		toTransform.setIdentity();
+		toTransform.setOrigin(to);
+
+		ClosestCallback callback(mask, entt::null);
+		for (const Tracked* candidate : m_candidates) {
+			btScalar fraction = callback.m_closestHitFraction;
+			btVector3 normal;
+			if (!btRayAabb(from, to, candidate->proxy->m_aabbMin, candidate->proxy->m_aabbMax, fraction, normal)) continue;
+			callback.TestBody(*candidate, fromTransform, toTransform);
+		}
+		if (callback.entity == entt::null) continue;
+
+		hits[i].entity = callback.entity;
+		hits[i].fraction = callback.m_closestHitFraction;
+		hits[i].position = glm::mix(rays[i].from, rays[i].to, hits[i].fraction);
+		hits[i].normal = {callback.normal.x(), callback.normal.y(), callback.normal.z()};
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <btBulletDynamicsCommon.h>
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <stdint.h>
+#include <vector>
+#include <wgleng/core/Components.h>
+
+class PhysicsSync;
+
+// flag masked raycasts that do not allocate. the engine does not expose its collision world,
+// so the bodies with PICKABLE or INTERACTABLE get a proxy in a broadphase of their own, with the
+// flags mirrored into bullet filter groups. a query walks that tree only, other bodies cost
+// nothing, and a candidate is rejected on its filter group before any shape test.
+// the flags are kept up to date from registry signals, a query never reads a FlagComponent.
+class PhysicsQueries {
+public:
+	using FlagMask = decltype(FlagComponent::flags);
+
+	struct Ray {
+		glm::vec3 from;
+		glm::vec3 to;
+	};
+	struct RayHit {
+		entt::entity entity = entt::null;
+		glm::vec3 position;
+		glm::vec3 normal;
+		float fraction = 1.0f; // 0 at ray start, 1 at ray end
+	};
+	// a body with query flags, the proxy's client object
+	struct Tracked {
+		entt::entity entity;
+		btCollisionObject* body;
+		btBroadphaseProxy* proxy;
+	};
+
+	// the only flags queries can mask on
+	static constexpr FlagMask QUERY_FLAGS = EntityFlags::PICKABLE | EntityFlags::INTERACTABLE;
+	// bullet filter groups the query flags are mirrored into, after the builtin ones.
+	// set on the engine's proxy of the body too, so engine side bullet queries can filter on them
+	static constexpr int PICKABLE_FILTER = 64;
+	static constexpr int INTERACTABLE_FILTER = 128;
+	static int FilterGroups(FlagMask flags);
+
+	PhysicsQueries(entt::registry& registry);
+	~PhysicsQueries();
+	PhysicsQueries(const PhysicsQueries&) = delete;
+	PhysicsQueries& operator=(const PhysicsQueries&) = delete;
+	PhysicsQueries(PhysicsQueries&&) = delete;
+	PhysicsQueries& operator=(PhysicsQueries&&) = delete;
+
+	// moves the proxies of the bodies bullet moved, call after every physics step
+	void Update(const PhysicsSync& physicsSync);
+	// moves every proxy, after transforms were set outside of a step
+	void Refresh();
+
+	// nearest body with any of the flags in mask, bodies without them never block the ray
+	bool RaycastClosest(const Ray& ray, FlagMask mask, RayHit& hit, entt::entity ignore = entt::null) const;
+	// up to hits.size() matching bodies sorted by distance, one hit per entity. returns the count written
+	uint32_t RaycastAll(const Ray& ray, FlagMask mask, std::span<RayHit> hits, entt::entity ignore = entt::null) const;
+	// closest hit for every ray, hits[i].entity is null on a miss. hits must be at least rays.size().
+	// the tree is walked once for the bounds of all rays, meant for rays close to each other
+	void RaycastClosestBatch(std::span<const Ray> rays, FlagMask mask, std::span<RayHit> hits) const;
+
+private:
+	void OnChanged(entt::registry& registry, entt::entity entity);
+	void OnDestroy(entt::registry& registry, entt::entity entity);
+	void Untrack(entt::entity entity);
+	void UpdateBounds(const Tracked& tracked);
+
+	entt::registry& m_registry;
+	// queries are const, walking the tree only uses its traversal stack
+	mutable btDbvtBroadphase m_broadphase;
+	// entity index -> its tracked body, the body may already be gone when the entity is destroyed
+	std::vector<std::unique_ptr<Tracked>> m_tracked;
+	// candidates of a batch, grows to the largest batch once
+	mutable std::vector<const Tracked*> m_candidates;
+};
@@ -0,0 +1,87 @@
+#include "PhysicsSync.h"
+
+#include <wgleng/core/Components.h>
+
+TrackedMotionState::TrackedMotionState(PhysicsSync& sync, entt::entity entity, btMotionState* inner, const btTransform& transform)
+	: m_sync(&sync), m_entity(entity), m_inner(inner), m_transform(transform) {}
+TrackedMotionState::~TrackedMotionState() {
+	// the engine deletes the body's motion state, which is this one, the original goes with it
+	delete m_inner;
+	m_inner = nullptr;
+}
+
+void TrackedMotionState::getWorldTransform(btTransform& transform) const {
+	if (m_inner) m_inner->getWorldTransform(transform);
+	else transform = m_transform;
+}
+void TrackedMotionState::setWorldTransform(const btTransform& transform) {
+	m_transform = transform;
+	if (m_inner) m_inner->setWorldTransform(transform);
+	if (m_sync) m_sync->OnMoved(*this);
+}
+
+PhysicsSync::PhysicsSync(entt::registry& registry)
+	: m_registry(registry) {
+	m_registry.on_construct<RigidBodyComponent>().connect<&PhysicsSync::OnConstruct>(*this);
+	m_registry.on_destroy<RigidBodyComponent>().connect<&PhysicsSync::OnDestroy>(*this);
+
+	for (const auto entity : m_registry.view<RigidBodyComponent>()) {
+		OnConstruct(m_registry, entity);
+	}
+}
+PhysicsSync::~PhysicsSync() {
+	m_registry.on_construct<RigidBodyComponent>().disconnect<&PhysicsSync::OnConstruct>(*this);
+	m_registry.on_destroy<RigidBodyComponent>().disconnect<&PhysicsSync::OnDestroy>(*this);
+	// bodies may outlive us, they keep the motion states
+	for (auto* state : m_states) {
+		if (state) state->m_sync = nullptr;
+	}
+}
+
+void PhysicsSync::OnConstruct(entt::registry& registry, entt::entity entity) {
+	btRigidBody* body = registry.get<RigidBodyComponent>(entity).body;
+	if (!body || dynamic_cast<TrackedMotionState*>(body->getMotionState())) return;
+
+	auto* state = new TrackedMotionState(*this, entity, body->getMotionState(), body->getWorldTransform());
+	body->setMotionState(state);
+
+	const auto index = static_cast<uint32_t>(entt::to_entity(entity));
+	if (index >= m_states.size()) m_states.resize(index + 1, nullptr);
+	m_states[index] = state;
+}
+void PhysicsSync::OnDestroy(entt::registry& registry, entt::entity entity) {
+	// the body and this motion state are the engine's to delete, just forget it
+	TrackedMotionState* state = GetState(entity);
+	if (!state) return;
+	state->m_sync = nullptr;
+	m_states[entt::to_entity(entity)] = nullptr;
+	std::erase_if(m_moved, [&](const MovedBody& moved) { return moved.entity == entity; });
+}
+
+void PhysicsSync::BeginStep() {
+	m_moved.clear();
+	m_step++;
+}
+void PhysicsSync::OnMoved(TrackedMotionState& state) {
+	// bullet may sync more than once per step with substeps
+	if (state.m_movedStep == m_step) return;
+	state.m_movedStep = m_step;
+	m_moved.push_back({state.m_entity, &state.m_transform});
+}
+
+TrackedMotionState* PhysicsSync::GetState(entt::entity entity) const {
+	const auto index = static_cast<uint32_t>(entt::to_entity(entity));
+	if (index >= m_states.size()) return nullptr;
+	TrackedMotionState* state = m_states[index];
+	if (!state || state->m_entity != entity) return nullptr;
+	return state;
+}
+const btTransform* PhysicsSync::GetMovedTransform(entt::entity entity) const {
+	const TrackedMotionState* state = GetState(entity);
+	if (!state || state->m_movedStep != m_step) return nullptr;
+	return &state->m_transform;
+}
+const btTransform* PhysicsSync::GetTransform(entt::entity entity) const {
+	const TrackedMotionState* state = GetState(entity);
+	return state ? &state->m_transform : nullptr;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <btBulletDynamicsCommon.h>
+#include <entt/entt.hpp>
+#include <stdint.h>
+#include <vector>
+
+class PhysicsSync;
+
+// wraps the body's original motion state. bullet only calls setWorldTransform for bodies
+// that are awake, so every call means the body really moved this step.
+// ownership: the wrapper takes the place of the original on the body and owns it. this relies
+// on the engine deleting body->getMotionState() together with the body, bullet's own convention,
+// which deletes the wrapper and with it the original. an engine that deleted the state it created
+// through its own pointer would leak the wrapper, nothing is ever deleted twice.
+class TrackedMotionState final : public btMotionState {
+public:
+	TrackedMotionState(PhysicsSync& sync, entt::entity entity, btMotionState* inner, const btTransform& transform);
+	~TrackedMotionState() override;
+	TrackedMotionState(const TrackedMotionState&) = delete;
+	TrackedMotionState& operator=(const TrackedMotionState&) = delete;
+
+	void getWorldTransform(btTransform& transform) const override;
+	void setWorldTransform(const btTransform& transform) override;
+
+	const btTransform& GetTransform() const { return m_transform; }
+
+private:
+	friend class PhysicsSync;
+	PhysicsSync* m_sync;
+	entt::entity m_entity;
+	btMotionState* m_inner;
+	btTransform m_transform;
+	uint32_t m_movedStep = 0;
+};
+
+// collects the bodies bullet moved during the last physics step.
+// consumers walk GetMoved() instead of polling every rigid body.
+class PhysicsSync {
+public:
+	struct MovedBody {
+		entt::entity entity;
+		const btTransform* transform;
+	};
+
+	PhysicsSync(entt::registry& registry);
+	~PhysicsSync();
+	PhysicsSync(const PhysicsSync&) = delete;
+	PhysicsSync& operator=(const PhysicsSync&) = delete;
+	PhysicsSync(PhysicsSync&&) = delete;
+	PhysicsSync& operator=(PhysicsSync&&) = delete;
+
+	// call right before stepping the physics world
+	void BeginStep();
+
+	const std::vector<MovedBody>& GetMoved() const { return m_moved; }
+	// transform written this step, nullptr if the body did not move
+	const btTransform* GetMovedTransform(entt::entity entity) const;
+	// last known transform, nullptr if the entity has no tracked body
+	const btTransform* GetTransform(entt::entity entity) const;
+
+private:
+	friend class TrackedMotionState;
+
+	void OnConstruct(entt::registry& registry, entt::entity entity);
+	void OnDestroy(entt::registry& registry, entt::entity entity);
+	void OnMoved(TrackedMotionState& state);
+	TrackedMotionState* GetState(entt::entity entity) const;
+
+	entt::registry& m_registry;
+	// entity index -> motion state
+	std::vector<TrackedMotionState*> m_states;
+	std::vector<MovedBody> m_moved;
+	uint32_t m_step = 1;
+};
@@ -0,0 +1,43 @@
+#include "RenderQueue.h"
+
+#include <emscripten/bind.h>
+#include <memory>
+#include <wgleng/core/Components.h>
+
+namespace {
+	bool s_enabled = true;
+}
+
+RenderQueue::RenderQueue(entt::registry& registry)
+	: m_registry(registry) {}
+
+void RenderQueue::SetEnabled(bool enabled) {
+	s_enabled = enabled;
+}
+
+void RenderQueue::Update() {
+	if (!s_enabled) return;
+	auto group = m_registry.group<MeshComponent, TransformComponent>();
+
+	// mesh ids in current group order, checking if they are already sorted
+	bool sorted = true;
+	uint32_t previous = 0;
+	for (auto&& [entity, meshComp, transformComp] : group.each()) {
+		const auto [it, inserted] = m_meshIds.try_emplace(std::to_address(meshComp.mesh), static_cast<uint32_t>(m_meshIds.size()));
+		const auto index = static_cast<uint32_t>(entt::to_entity(entity));
+		if (index >= m_meshKeys.size()) m_meshKeys.resize(index + 1);
+		m_meshKeys[index] = it->second;
+		if (it->second < previous) sorted = false;
+		previous = it->second;
+	}
+	if (sorted) return;
+
+	// one sort, the group is mostly in order already and equal meshes keep their order
+	group.sort([&](const entt::entity lhs, const entt::entity rhs) {
+		return m_meshKeys[entt::to_entity(lhs)] < m_meshKeys[entt::to_entity(rhs)];
+	}, entt::insertion_sort{});
+}
+
+EMSCRIPTEN_BINDINGS(render_queue) {
+	emscripten::function("setRenderQueueEnabled", &RenderQueue::SetEnabled);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+// orders the mesh group by mesh, so the renderer walking it in registry order draws each
+// mesh's instances back to back and the gl driver sees the same vertex array bound again
+// instead of a new one per entity. highlights are left out of the order, hovering an object
+// changes its highlight every few frames and must not move it in the group. nothing depends
+// on the camera either, so the group is only sorted when entities or meshes change, with
+// entt's insertion sort that only moves what is out of place. the engine still issues every
+// bind, skipping the repeated ones has to happen in its renderer.
+class RenderQueue {
+public:
+	RenderQueue(entt::registry& registry);
+
+	// reorders the group if an entity is out of mesh order
+	void Update();
+
+	// off stops reordering, a level loaded while off keeps its load order.
+	// to compare the recorded gl calls with and without, setRenderQueueEnabled() in js
+	static void SetEnabled(bool enabled);
+
+private:
+	entt::registry& m_registry;
+	// dense ids in first seen order
+	std::unordered_map<const void*, uint32_t> m_meshIds;
+	// entity index -> id of its mesh
+	std::vector<uint32_t> m_meshKeys;
+};
@@ -0,0 +1,77 @@
+#include "AdaptiveLevel.h"
+
+#include <algorithm>
+
+namespace {
+	constexpr uint32_t EVALUATE_INTERVAL = 30;
+	// hysteresis, step down well above budget, count as good only within budget
+	constexpr float STEP_DOWN_RATIO = 1.2f;
+	constexpr float GOOD_RATIO = 1.05f;
+	constexpr float MIN_STEP_UP_DELAY = 5.0f;
+	constexpr float MAX_STEP_UP_DELAY = 60.0f;
+	// a step down this soon after a step up means the step up was a mistake
+	constexpr float FAILED_STEP_UP_WINDOW = 8.0f;
+	// hitches and tab switches say nothing about render cost
+	constexpr float MAX_SAMPLE_MS = 250.0f;
+}
+
+void AdaptiveLevel::SetLevelCount(uint32_t count) {
+	m_levelCount = std::max<uint32_t>(count, 1);
+	m_stepUpDelay = MIN_STEP_UP_DELAY;
+	Restart();
+}
+void AdaptiveLevel::SetTargetFps(float fps) {
+	m_budgetMs = 1000.0f / std::max(fps, 1.0f);
+	ClearSamples();
+}
+void AdaptiveLevel::Restart() {
+	m_level = 0;
+	ClearSamples();
+}
+void AdaptiveLevel::ClearSamples() {
+	m_sampleCount = 0;
+	m_sampleIndex = 0;
+	m_framesSinceEvaluate = 0;
+	m_goodSeconds = 0;
+}
+
+bool AdaptiveLevel::AddFrame(float ms) {
+	m_sinceStepUp += ms / 1000.0f;
+	if (ms < MAX_SAMPLE_MS) {
+		m_samples[m_sampleIndex] = ms;
+		m_sampleIndex = (m_sampleIndex + 1) % SAMPLE_COUNT;
+		m_sampleCount = std::min(m_sampleCount + 1, SAMPLE_COUNT);
+		m_goodSeconds += ms / 1000.0f;
+	}
+	if (++m_framesSinceEvaluate < EVALUATE_INTERVAL || m_sampleCount < SAMPLE_COUNT) return false;
+	m_framesSinceEvaluate = 0;
+	return Evaluate();
+}
+bool AdaptiveLevel::Evaluate() {
+	std::array<float, SAMPLE_COUNT> sorted = m_samples;
+	std::nth_element(sorted.begin(), sorted.begin() + SAMPLE_COUNT / 2, sorted.end());
+	m_p50 = sorted[SAMPLE_COUNT / 2];
+	std::nth_element(sorted.begin(), sorted.begin() + SAMPLE_COUNT * 9 / 10, sorted.end());
+	m_p90 = sorted[SAMPLE_COUNT * 9 / 10];
+
+	if (m_p90 > m_budgetMs * STEP_DOWN_RATIO) {
+		if (m_level + 1 >= m_levelCount) return false;
+		m_level++;
+		// the level above could not hold the target, wait longer before trying it again
+		if (m_sinceStepUp < FAILED_STEP_UP_WINDOW) {
+			m_stepUpDelay = std::min(m_stepUpDelay * 2.0f, MAX_STEP_UP_DELAY);
+		}
+		ClearSamples();
+		return true;
+	}
+
+	if (m_p90 > m_budgetMs * GOOD_RATIO) {
+		m_goodSeconds = 0;
+		return false;
+	}
+	if (m_level == 0 || m_goodSeconds < m_stepUpDelay) return false;
+	m_level--;
+	m_sinceStepUp = 0;
+	ClearSamples();
+	return true;
+}
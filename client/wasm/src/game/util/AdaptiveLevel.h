@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <stdint.h>
+
+// frame time side of adaptive quality. keeps rolling frame time percentiles and walks a
+// ladder of levels, 0 is full quality and higher levels are cheaper. steps down quickly
+// when over budget, steps back up only after a stretch within budget, and waits longer
+// every time a step up had to be undone. engine independent, QualityGovernor maps the
+// levels to renderer settings.
+class AdaptiveLevel {
+public:
+	// restarts at level 0 with the initial step up delay
+	void SetLevelCount(uint32_t count);
+	void SetTargetFps(float fps);
+	// back to level 0, the step up delay stays
+	void Restart();
+	// frames before this do not count, e.g. after something else changed the renderer
+	void ClearSamples();
+
+	// true when the level changed
+	bool AddFrame(float ms);
+
+	uint32_t GetLevel() const { return m_level; }
+	uint32_t GetLevelCount() const { return m_levelCount; }
+	float GetFrameTimeP50() const { return m_p50; }
+	float GetFrameTimeP90() const { return m_p90; }
+	float GetStepUpDelay() const { return m_stepUpDelay; }
+
+private:
+	static constexpr uint32_t SAMPLE_COUNT = 120;
+
+	bool Evaluate();
+
+	uint32_t m_levelCount = 1;
+	uint32_t m_level = 0;
+
+	std::array<float, SAMPLE_COUNT> m_samples{};
+	uint32_t m_sampleCount = 0;
+	uint32_t m_sampleIndex = 0;
+	uint32_t m_framesSinceEvaluate = 0;
+	float m_p50 = 0;
+	float m_p90 = 0;
+
+	float m_budgetMs = 1000.0f / 60.0f;
+	float m_goodSeconds = 0;       // time spent comfortably within budget
+	float m_stepUpDelay = 5.0f;    // grows every time a step up had to be undone
+	float m_sinceStepUp = 1e9f;    // seconds since the last step up
+};
@@ -0,0 +1,218 @@
+#include "AllocTracker.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/bind.h>
+#include <emscripten/emscripten.h>
+#else
+#include <execinfo.h>
+#endif
+
+namespace {
+	using AllocTracker::Site;
+	using AllocTracker::STACK_DEPTH;
+
+	// fixed tables, the hooks must not allocate
+	constexpr uint32_t SITE_CAPACITY = 4096;
+	// frames belonging to the tracker and operator new itself
+	constexpr uint32_t SKIPPED_FRAMES = 3;
+
+	Site s_sites[SITE_CAPACITY];
+	bool s_used[SITE_CAPACITY];
+	uint16_t s_touched[SITE_CAPACITY];
+	uint32_t s_touchedCount = 0;
+
+	bool s_inside = false;
+	uint32_t s_frameAllocations = 0;
+	uint32_t s_lastFrameAllocations = 0;
+	uint32_t s_framesUntilSettled = 300;
+	uint32_t s_settledFrames = 0;
+
+	uint32_t CaptureStack(uintptr_t* frames) {
+		constexpr uint32_t capacity = STACK_DEPTH + SKIPPED_FRAMES;
+#ifdef __EMSCRIPTEN__
+		uintptr_t buffer[capacity];
+		const uint32_t count = emscripten_stack_unwind_buffer(emscripten_stack_snapshot(), buffer, capacity);
+#else
+		void* buffer[capacity];
+		const auto count = static_cast<uint32_t>(backtrace(buffer, capacity));
+#endif
+		uint32_t written = 0;
+		for (uint32_t i = SKIPPED_FRAMES; i < count; i++) {
+			frames[written++] = reinterpret_cast<uintptr_t>(buffer[i]);
+		}
+		for (uint32_t i = written; i < STACK_DEPTH; i++) frames[i] = 0;
+		return written;
+	}
+
+	uint16_t FindOrInsert(const uintptr_t* frames) {
+		uint64_t hash = 1469598103934665603ull;
+		for (uint32_t i = 0; i < STACK_DEPTH; i++) {
+			hash = (hash ^ frames[i]) * 1099511628211ull;
+		}
+		for (uint32_t probe = 0; probe < SITE_CAPACITY; probe++) {
+			const uint32_t index = static_cast<uint32_t>(hash + probe) & (SITE_CAPACITY - 1);
+			if (!s_used[index]) {
+				s_used[index] = true;
+				s_sites[index] = {};
+				std::copy_n(frames, STACK_DEPTH, s_sites[index].frames);
+				return static_cast<uint16_t>(index);
+			}
+			if (std::equal(frames, frames + STACK_DEPTH, s_sites[index].frames)) {
+				return static_cast<uint16_t>(index);
+			}
+		}
+		return AllocTracker::NO_SITE;
+	}
+
+	std::string DescribeFrame(uintptr_t pc) {
+#ifdef __EMSCRIPTEN__
+		const char* function = emscripten_pc_get_function(pc);
+		const char* file = emscripten_pc_get_file(pc);
+		return std::string(function ? function : "?") + " (" + (file ? file : "?") + ":" +
+			std::to_string(emscripten_pc_get_line(pc)) + ")";
+#else
+		void* address = reinterpret_cast<void*>(pc);
+		char** symbols = backtrace_symbols(&address, 1);
+		std::string result = symbols ? symbols[0] : "?";
+		std::free(symbols);
+		return result;
+#endif
+	}
+	void AppendJsonString(std::string& out, const std::string& text) {
+		out += '"';
+		for (const char c : text) {
+			if (c == '"' || c == '\\') out += '\\';
+			if (static_cast<unsigned char>(c) >= 0x20) out += c;
+		}
+		out += '"';
+	}
+}
+
+uint16_t AllocTracker::OnAllocate(size_t size) {
+	s_frameAllocations++;
+	// unwinding may allocate on some platforms
+	if (s_inside) return NO_SITE;
+	s_inside = true;
+
+	uintptr_t frames[STACK_DEPTH];
+	CaptureStack(frames);
+	const uint16_t index = FindOrInsert(frames);
+	if (index != NO_SITE) {
+		Site& site = s_sites[index];
+		site.allocations++;
+		site.bytes += size;
+		site.liveBytes += size;
+		if (site.allocationsThisFrame++ == 0) s_touched[s_touchedCount++] = index;
+		if (s_framesUntilSettled == 0) site.settledAllocations++;
+	}
+
+	s_inside = false;
+	return index;
+}
+void AllocTracker::OnFree(uint16_t site, size_t size) {
+	if (site == NO_SITE || site >= SITE_CAPACITY || !s_used[site]) return;
+	s_sites[site].liveBytes -= std::min<uint64_t>(size, s_sites[site].liveBytes);
+}
+
+void AllocTracker::EndFrame() {
+	const bool settled = s_framesUntilSettled == 0;
+	for (uint32_t i = 0; i < s_touchedCount; i++) {
+		Site& site = s_sites[s_touched[i]];
+		if (settled) site.settledFrames++;
+		site.allocationsThisFrame = 0;
+	}
+	s_touchedCount = 0;
+	s_lastFrameAllocations = s_frameAllocations;
+	s_frameAllocations = 0;
+
+	if (settled) {
+		s_settledFrames++;
+	} else {
+		s_framesUntilSettled--;
+	}
+}
+void AllocTracker::Reset(uint32_t settleFrames) {
+	for (uint32_t i = 0; i < SITE_CAPACITY; i++) {
+		if (!s_used[i]) continue;
+		s_sites[i].settledAllocations = 0;
+		s_sites[i].settledFrames = 0;
+	}
+	s_framesUntilSettled = std::max<uint32_t>(settleFrames, 1);
+	s_settledFrames = 0;
+}
+bool AllocTracker::IsSettled() {
+	return s_framesUntilSettled == 0;
+}
+uint32_t AllocTracker::GetFrameAllocations() {
+	return s_lastFrameAllocations;
+}
+
+float AllocTracker::GetAllocationsPerFrame(const Site& site) {
+	if (s_settledFrames == 0) return 0;
+	return static_cast<float>(site.settledAllocations) / static_cast<float>(s_settledFrames);
+}
+uint32_t AllocTracker::GetSteadySites(const Site** out, uint32_t maxCount) {
+	if (s_settledFrames < 60) return 0;
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < SITE_CAPACITY; i++) {
+		if (!s_used[i]) continue;
+		const Site& site = s_sites[i];
+		// allocated in at least 90% of the settled frames
+		if (site.settledFrames * 10 < s_settledFrames * 9) continue;
+
+		// keep the top maxCount sorted by allocations per frame
+		uint32_t pos = std::min(count, maxCount);
+		while (pos > 0 && out[pos - 1]->settledAllocations < site.settledAllocations) {
+			if (pos < maxCount) out[pos] = out[pos - 1];
+			pos--;
+		}
+		if (pos < maxCount) {
+			out[pos] = &site;
+			count = std::min(count + 1, maxCount);
+		}
+	}
+	return count;
+}
+
+std::string AllocTracker::DescribeSite(const Site& site) {
+	std::string result;
+	for (uint32_t i = 0; i < STACK_DEPTH && site.frames[i]; i++) {
+		result += "  " + DescribeFrame(site.frames[i]) + "\n";
+	}
+	return result;
+}
+std::string AllocTracker::GetReportJson(uint32_t maxCount) {
+	constexpr uint32_t maxReported = 32;
+	const Site* sites[maxReported];
+	const uint32_t count = GetSteadySites(sites, std::min(maxCount, maxReported));
+
+	std::string json = "{\"settled\":" + std::string(IsSettled() ? "true" : "false") +
+		",\"frameAllocations\":" + std::to_string(s_lastFrameAllocations) +
+		",\"settledFrames\":" + std::to_string(s_settledFrames) + ",\"sites\":[";
+	for (uint32_t i = 0; i < count; i++) {
+		const Site& site = *sites[i];
+		if (i > 0) json += ',';
+		json += "{\"allocationsPerFrame\":" + std::to_string(GetAllocationsPerFrame(site)) +
+			",\"bytes\":" + std::to_string(site.bytes) + ",\"liveBytes\":" + std::to_string(site.liveBytes) + ",\"stack\":[";
+		for (uint32_t frame = 0; frame < STACK_DEPTH && site.frames[frame]; frame++) {
+			if (frame > 0) json += ',';
+			AppendJsonString(json, DescribeFrame(site.frames[frame]));
+		}
+		json += "]}";
+	}
+	json += "]}";
+	return json;
+}
+
+#ifdef __EMSCRIPTEN__
+std::string getAllocationReport() {
+	return AllocTracker::GetReportJson();
+}
+
+EMSCRIPTEN_BINDINGS(alloc_tracker) {
+	emscripten::function("getAllocationReport", &getAllocationReport);
+}
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+// allocation site tracker, compiled in with WASMGAME_ALLOC_TRACKING (debug builds).
+// every operator new is attributed to its call stack and counted per frame, so sites
+// that still allocate every frame after the scene settled can be found and budgeted.
+namespace AllocTracker {
+	constexpr uint32_t STACK_DEPTH = 6;
+	constexpr uint16_t NO_SITE = 0xffff;
+
+	struct Site {
+		uintptr_t frames[STACK_DEPTH];
+		uint64_t allocations;
+		uint64_t bytes;
+		uint64_t liveBytes;
+		uint64_t settledAllocations; // since the scene settled
+		uint32_t settledFrames;      // frames since settling in which this site allocated
+		uint32_t allocationsThisFrame;
+	};
+
+	// called by the allocation hooks, returns the site id stored with the block
+	uint16_t OnAllocate(size_t size);
+	void OnFree(uint16_t site, size_t size);
+
+	void EndFrame();
+	// restarts the settle period, e.g. after loading a scene
+	void Reset(uint32_t settleFrames = 300);
+	bool IsSettled();
+	// all allocations during the last frame, the zero allocation budget checks this
+	uint32_t GetFrameAllocations();
+	// sites that allocated in almost every frame since settling, most allocations per frame first
+	uint32_t GetSteadySites(const Site** out, uint32_t maxCount);
+	float GetAllocationsPerFrame(const Site& site);
+	std::string DescribeSite(const Site& site);
+	// steady state sites and the last frame's count as json, getAllocationReport() in js
+	std::string GetReportJson(uint32_t maxCount = 10);
+}
@@ -0,0 +1,54 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <format>
+
+const Benchmark::Result& Benchmark::Suite::AddSamples(std::string_view name, std::span<const double> samples) {
+	Result result{std::string(name), static_cast<uint32_t>(samples.size())};
+	if (!samples.empty()) {
+		std::vector<double> sorted(samples.begin(), samples.end());
+		std::sort(sorted.begin(), sorted.end());
+		const size_t count = sorted.size();
+		double sum = 0;
+		for (const double sample : sorted) sum += sample;
+		result.minNs = sorted.front();
+		result.medianNs = sorted[count / 2];
+		result.p90Ns = sorted[std::min(count - 1, count * 9 / 10)];
+		result.meanNs = sum / static_cast<double>(count);
+		double variance = 0;
+		for (const double sample : sorted) variance += (sample - result.meanNs) * (sample - result.meanNs);
+		result.stddevNs = std::sqrt(variance / static_cast<double>(count));
+	}
+	return m_results.emplace_back(std::move(result));
+}
+void Benchmark::Suite::AddValue(std::string_view name, double value) {
+	m_values.emplace_back(std::string(name), value);
+}
+
+std::string Benchmark::Suite::ToJson() const {
+	std::string json = std::format("{{\n  \"suite\": \"{}\",\n  \"cases\": {{", m_name);
+	for (size_t i = 0; i < m_results.size(); i++) {
+		const Result& r = m_results[i];
+		json += std::format("{}\n    \"{}\": {{\"iterations\": {}, \"min_ns\": {:.0f}, \"median_ns\": {:.0f}, "
+			"\"mean_ns\": {:.0f}, \"p90_ns\": {:.0f}, \"stddev_ns\": {:.0f}}}",
+			i == 0 ? "" : ",", r.name, r.iterations, r.minNs, r.medianNs, r.meanNs, r.p90Ns, r.stddevNs);
+	}
+	json += "\n  },\n  \"values\": {";
+	for (size_t i = 0; i < m_values.size(); i++) {
+		json += std::format("{}\n    \"{}\": {:.3f}", i == 0 ? "" : ",", m_values[i].first, m_values[i].second);
+	}
+	json += "\n  }\n}\n";
+	return json;
+}
+void Benchmark::Suite::Print() const {
+	std::printf("%s benchmarks\n", m_name.c_str());
+	for (const Result& r : m_results) {
+		std::printf("  %-32s %12.0f ns median  %12.0f ns p90  +-%.0f ns  (%u runs)\n",
+			r.name.c_str(), r.medianNs, r.p90Ns, r.stddevNs, r.iterations);
+	}
+	for (const auto& [name, value] : m_values) {
+		std::printf("  %-32s %12.3f\n", name.c_str(), value);
+	}
+}
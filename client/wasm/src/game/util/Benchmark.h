@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <span>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// fixed iteration benchmarks with summary statistics and json output.
+// results are compared against bench/baseline.json by bench/compare.py.
+namespace Benchmark {
+	struct Result {
+		std::string name;
+		uint32_t iterations;
+		double minNs;
+		double medianNs;
+		double meanNs;
+		double p90Ns;
+		double stddevNs;
+	};
+
+	class Suite {
+	public:
+		explicit Suite(std::string name) : m_name(std::move(name)) {}
+
+		// setup runs before every iteration and is not timed
+		template <typename Setup, typename Fn>
+		const Result& Run(std::string_view name, uint32_t iterations, Setup&& setup, Fn&& fn) {
+			// one untimed warmup, first calls pay for lazy init
+			setup();
+			fn();
+
+			m_samples.clear();
+			for (uint32_t i = 0; i < iterations; i++) {
+				setup();
+				const auto start = std::chrono::steady_clock::now();
+				fn();
+				const auto end = std::chrono::steady_clock::now();
+				m_samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+			}
+			return AddSamples(name, m_samples);
+		}
+		template <typename Fn>
+		const Result& Run(std::string_view name, uint32_t iterations, Fn&& fn) {
+			return Run(name, iterations, [] {}, fn);
+		}
+
+		// for samples timed by the caller, like one phase inside a bigger update
+		const Result& AddSamples(std::string_view name, std::span<const double> samples);
+		// a measured quantity that is not a time, like memory at a scene size. listed with the
+		// results, compare.py does not check values
+		void AddValue(std::string_view name, double value);
+
+		const std::vector<Result>& GetResults() const { return m_results; }
+		std::string ToJson() const;
+		void Print() const;
+
+	private:
+		std::string m_name;
+		std::vector<double> m_samples;
+		std::vector<Result> m_results;
+		std::vector<std::pair<std::string, double>> m_values;
+	};
+}
@@ -0,0 +1,36 @@
+#include "Histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+void LogHistogram::Add(float ms) {
+	// bucket 0 takes everything up to MIN_MS
+	uint32_t bucket = 0;
+	if (ms > MIN_MS) {
+		const float index = std::log2(ms / MIN_MS) * BUCKETS_PER_OCTAVE;
+		bucket = std::min(static_cast<uint32_t>(index) + 1, BUCKET_COUNT - 1);
+	}
+	m_buckets[bucket]++;
+	m_count++;
+	m_max = std::max(m_max, ms);
+	m_sum += ms;
+}
+void LogHistogram::Clear() {
+	m_buckets.fill(0);
+	m_count = 0;
+	m_max = 0;
+	m_sum = 0;
+}
+
+float LogHistogram::GetPercentile(float p) const {
+	if (m_count == 0) return 0;
+	const auto rank = static_cast<uint32_t>(std::ceil(std::clamp(p, 0.0f, 1.0f) * m_count));
+	uint32_t seen = 0;
+	for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+		seen += m_buckets[i];
+		if (seen < std::max(rank, 1u)) continue;
+		const float upper = MIN_MS * std::exp2(static_cast<float>(i) / BUCKETS_PER_OCTAVE);
+		return std::min(upper, m_max);
+	}
+	return m_max;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+#include <stdint.h>
+
+// millisecond histogram with log scale buckets, 8 per doubling (~9% wide) from 0.01 ms to
+// about 80 s. adding is a log2 and an increment, percentiles are exact to one bucket,
+// nothing allocates, so it can take every frame for as long as the page is open.
+class LogHistogram {
+public:
+	void Add(float ms);
+	void Clear();
+
+	uint32_t GetCount() const { return m_count; }
+	float GetMax() const { return m_max; }
+	float GetMean() const { return m_count ? static_cast<float>(m_sum / m_count) : 0.0f; }
+	// upper edge of the bucket holding the p'th sample, p in [0, 1], never above the max
+	float GetPercentile(float p) const;
+
+private:
+	static constexpr uint32_t BUCKETS_PER_OCTAVE = 8;
+	static constexpr uint32_t OCTAVES = 23;
+	static constexpr uint32_t BUCKET_COUNT = BUCKETS_PER_OCTAVE * OCTAVES + 1;
+	static constexpr float MIN_MS = 0.01f;
+
+	std::array<uint32_t, BUCKET_COUNT> m_buckets{};
+	uint32_t m_count = 0;
+	float m_max = 0;
+	double m_sum = 0;
+};
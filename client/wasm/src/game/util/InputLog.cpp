@@ -0,0 +1,196 @@
+#include "InputLog.h"
+
+#include <bit>
+
+namespace {
+	constexpr uint8_t MAGIC[2] = {'I', 'L'};
+	// tag bits of a step record, the rest of the tag is the repeat count
+	constexpr uint32_t KEYS_CHANGED = 1 << 0;
+	constexpr uint32_t LOOK_CHANGED = 1 << 1;
+	constexpr uint32_t TAG_BITS = 2;
+	// a decoder must not allocate whatever a hostile header asks for, ~5 hours of play
+	constexpr uint32_t MAX_STEPS = InputLog::STEP_HZ * 60 * 60 * 5;
+
+	constexpr char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	void WriteVarint(std::vector<uint8_t>& out, uint32_t value) {
+		while (value >= 0x80) {
+			out.push_back(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<uint8_t>(value));
+	}
+	uint32_t ZigZag(int32_t value) {
+		return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+	}
+	int32_t UnZigZag(uint32_t value) {
+		return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+	}
+
+	class Reader {
+	public:
+		explicit Reader(std::span<const uint8_t> data) : m_data(data) {}
+
+		bool Byte(uint8_t& value) {
+			if (m_pos >= m_data.size()) return false;
+			value = m_data[m_pos++];
+			return true;
+		}
+		bool Varint(uint32_t& value) {
+			value = 0;
+			for (uint32_t shift = 0; shift < 35; shift += 7) {
+				uint8_t byte;
+				if (!Byte(byte)) return false;
+				value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+				if (!(byte & 0x80)) return true;
+			}
+			return false;
+		}
+		bool AtEnd() const { return m_pos == m_data.size(); }
+
+	private:
+		std::span<const uint8_t> m_data;
+		size_t m_pos = 0;
+	};
+}
+
+void InputLog::Clear() {
+	m_frames.clear();
+	m_events.clear();
+	m_winStep = NO_STEP;
+}
+void InputLog::PushEvent(InputEvent type) {
+	m_events.push_back({GetStepCount(), type});
+}
+
+std::vector<uint8_t> InputLog::Encode() const {
+	std::vector<uint8_t> out(std::begin(MAGIC), std::end(MAGIC));
+	WriteVarint(out, VERSION);
+	WriteVarint(out, STEP_HZ);
+	WriteVarint(out, std::bit_cast<uint32_t>(m_mouseSensitivity));
+	WriteVarint(out, m_winStep + 1); // 0 when the log ends without a win
+	WriteVarint(out, GetStepCount());
+
+	InputFrame previous{};
+	for (size_t i = 0; i < m_frames.size();) {
+		const InputFrame& frame = m_frames[i];
+		uint32_t repeat = 0;
+		while (i + 1 + repeat < m_frames.size() && m_frames[i + 1 + repeat] == frame) repeat++;
+
+		uint32_t tag = repeat << TAG_BITS;
+		if (frame.keys != previous.keys) tag |= KEYS_CHANGED;
+		if (frame.lookX != previous.lookX || frame.lookY != previous.lookY) tag |= LOOK_CHANGED;
+		WriteVarint(out, tag);
+		if (tag & KEYS_CHANGED) WriteVarint(out, frame.keys ^ previous.keys);
+		if (tag & LOOK_CHANGED) {
+			WriteVarint(out, ZigZag(frame.lookX - previous.lookX));
+			WriteVarint(out, ZigZag(frame.lookY - previous.lookY));
+		}
+		previous = frame;
+		i += 1 + repeat;
+	}
+
+	WriteVarint(out, static_cast<uint32_t>(m_events.size()));
+	uint32_t lastStep = 0;
+	for (const Event& event : m_events) {
+		WriteVarint(out, event.step - lastStep);
+		out.push_back(static_cast<uint8_t>(event.type));
+		lastStep = event.step;
+	}
+	return out;
+}
+
+std::optional<InputLog> InputLog::Decode(std::span<const uint8_t> data) {
+	Reader reader(data);
+	uint8_t magic[2];
+	if (!reader.Byte(magic[0]) || !reader.Byte(magic[1])) return std::nullopt;
+	if (magic[0] != MAGIC[0] || magic[1] != MAGIC[1]) return std::nullopt;
+
+	uint32_t version, stepHz, sensitivity, winStep, stepCount;
+	if (!reader.Varint(version) || version != VERSION) return std::nullopt;
+	if (!reader.Varint(stepHz) || stepHz != STEP_HZ) return std::nullopt;
+	if (!reader.Varint(sensitivity) || !reader.Varint(winStep) || !reader.Varint(stepCount)) return std::nullopt;
+	if (stepCount > MAX_STEPS) return std::nullopt;
+
+	InputLog log;
+	log.m_mouseSensitivity = std::bit_cast<float>(sensitivity);
+	log.m_winStep = winStep - 1;
+	if (log.m_winStep != NO_STEP && log.m_winStep > stepCount) return std::nullopt;
+	log.m_frames.reserve(stepCount);
+
+	InputFrame frame{};
+	while (log.GetStepCount() < stepCount) {
+		uint32_t tag;
+		if (!reader.Varint(tag)) return std::nullopt;
+		if (tag & KEYS_CHANGED) {
+			uint32_t keys;
+			if (!reader.Varint(keys) || keys > 0xffff) return std::nullopt;
+			frame.keys ^= static_cast<uint16_t>(keys);
+		}
+		if (tag & LOOK_CHANGED) {
+			uint32_t dx, dy;
+			if (!reader.Varint(dx) || !reader.Varint(dy)) return std::nullopt;
+			frame.lookX = static_cast<int16_t>(frame.lookX + UnZigZag(dx));
+			frame.lookY = static_cast<int16_t>(frame.lookY + UnZigZag(dy));
+		}
+		const uint32_t count = (tag >> TAG_BITS) + 1;
+		if (count > stepCount - log.GetStepCount()) return std::nullopt;
+		log.m_frames.insert(log.m_frames.end(), count, frame);
+	}
+
+	uint32_t eventCount;
+	if (!reader.Varint(eventCount) || eventCount > stepCount + 1) return std::nullopt;
+	uint32_t step = 0;
+	for (uint32_t i = 0; i < eventCount; i++) {
+		uint32_t delta;
+		uint8_t type;
+		if (!reader.Varint(delta) || !reader.Byte(type)) return std::nullopt;
+		if (type >= static_cast<uint8_t>(InputEvent::EventCount)) return std::nullopt;
+		step += delta;
+		if (step > stepCount) return std::nullopt;
+		log.m_events.push_back({step, static_cast<InputEvent>(type)});
+	}
+	if (!reader.AtEnd()) return std::nullopt;
+	return log;
+}
+
+std::string InputLog::EncodeBase64() const {
+	const std::vector<uint8_t> data = Encode();
+	std::string result;
+	result.reserve((data.size() + 2) / 3 * 4);
+	for (size_t i = 0; i < data.size(); i += 3) {
+		const size_t remaining = data.size() - i;
+		uint32_t chunk = data[i] << 16;
+		if (remaining > 1) chunk |= data[i + 1] << 8;
+		if (remaining > 2) chunk |= data[i + 2];
+		result += BASE64[(chunk >> 18) & 63];
+		result += BASE64[(chunk >> 12) & 63];
+		result += remaining > 1 ? BASE64[(chunk >> 6) & 63] : '=';
+		result += remaining > 2 ? BASE64[chunk & 63] : '=';
+	}
+	return result;
+}
+
+std::optional<InputLog> InputLog::DecodeBase64(std::string_view text) {
+	std::vector<uint8_t> data;
+	data.reserve(text.size() / 4 * 3);
+	uint32_t chunk = 0;
+	uint32_t bits = 0;
+	for (const char c : text) {
+		if (c == '=') break;
+		uint32_t value;
+		if (c >= 'A' && c <= 'Z') value = c - 'A';
+		else if (c >= 'a' && c <= 'z') value = c - 'a' + 26;
+		else if (c >= '0' && c <= '9') value = c - '0' + 52;
+		else if (c == '+') value = 62;
+		else if (c == '/') value = 63;
+		else return std::nullopt;
+		chunk = (chunk << 6) | value;
+		bits += 6;
+		if (bits >= 8) {
+			bits -= 8;
+			data.push_back(static_cast<uint8_t>(chunk >> bits));
+		}
+	}
+	return Decode(data);
+}
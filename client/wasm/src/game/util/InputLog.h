@@ -0,0 +1,84 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// player input of one fixed simulation step, everything the simulation reads from the user
+struct InputFrame {
+	enum Key : uint16_t {
+		FORWARD = 1 << 0,
+		BACK = 1 << 1,
+		LEFT = 1 << 2,
+		RIGHT = 1 << 3,
+		JUMP = 1 << 4,
+		SPRINT = 1 << 5,
+		DOWN = 1 << 6,
+		PICKUP = 1 << 7,
+		THROW = 1 << 8,
+		INTERACT = 1 << 9,
+	};
+
+	uint16_t keys = 0;
+	// mouse look applied before this step, whole css pixels
+	int16_t lookX = 0;
+	int16_t lookY = 0;
+
+	bool IsHeld(Key key) const { return keys & key; }
+	bool operator==(const InputFrame&) const = default;
+};
+
+// things the simulation does not decide itself, like server replies, applied between steps
+enum class InputEvent : uint8_t {
+	DoorOpened,
+	EventCount,
+};
+
+// input/tick log of one play session. stored as a run length, delta and varint encoded
+// byte stream: held keys are xor'd with the previous step, look deltas are zigzag coded
+// against the previous step and identical steps collapse into a repeat count. a minute of
+// idle play is a few bytes, a minute of constant mouse look about 10 KB.
+// engine independent. the server decodes the same format in Task3InputLog.cs, keep them in sync.
+class InputLog {
+public:
+	static constexpr uint32_t VERSION = 1;
+	static constexpr uint32_t STEP_HZ = 60;
+	static constexpr uint32_t NO_STEP = 0xffffffff;
+
+	// applied before the frame at `step` is simulated
+	struct Event {
+		uint32_t step;
+		InputEvent type;
+	};
+
+	void Clear();
+	void Push(const InputFrame& frame) { m_frames.push_back(frame); }
+	// at the current step, before the next pushed frame is simulated
+	void PushEvent(InputEvent type);
+	// steps simulated up to and including the one that won, a won log ends at its win step
+	void SetWinStep(uint32_t step) { m_winStep = step; }
+	void SetMouseSensitivity(float sensitivity) { m_mouseSensitivity = sensitivity; }
+
+	uint32_t GetStepCount() const { return static_cast<uint32_t>(m_frames.size()); }
+	const InputFrame& GetFrame(uint32_t step) const { return m_frames[step]; }
+	std::span<const Event> GetEvents() const { return m_events; }
+	uint32_t GetWinStep() const { return m_winStep; }
+	float GetMouseSensitivity() const { return m_mouseSensitivity; }
+	// whole seconds from the first step to the win, what the timer showed
+	int32_t GetWinSeconds() const { return m_winStep == NO_STEP ? -1 : static_cast<int32_t>(m_winStep / STEP_HZ); }
+
+	std::vector<uint8_t> Encode() const;
+	static std::optional<InputLog> Decode(std::span<const uint8_t> data);
+	// base64 of the encoded log, for sending it along with the score
+	std::string EncodeBase64() const;
+	static std::optional<InputLog> DecodeBase64(std::string_view text);
+
+private:
+	std::vector<InputFrame> m_frames;
+	std::vector<Event> m_events;
+	uint32_t m_winStep = NO_STEP;
+	float m_mouseSensitivity = 0.5f;
+};
@@ -0,0 +1,297 @@
+#include "MemoryStats.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+// the headless native build has no engine, no bullet and no imgui
+#ifndef WASMGAME_HEADLESS
+#include <LinearMath/btAlignedAllocator.h>
+#ifndef WASMGAME_SLIM
+#include <wgleng/vendor/imgui/imgui.h>
+#endif
+#endif
+
+#ifdef WASMGAME_ALLOC_TRACKING
+#include "AllocTracker.h"
+#endif
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/bind.h>
+#include <emscripten/heap.h>
+#endif
+
+namespace {
+	// sits right before every block from Allocate
+	struct BlockHeader {
+		uint8_t tag;
+		uint8_t offsetLog2; // distance back to the start of the real allocation
+		uint16_t site; // allocation site when tracking is compiled in
+		uint32_t padding;
+		uint64_t size;
+	};
+	static_assert(sizeof(BlockHeader) == 16);
+
+	constexpr size_t TAG_COUNT = static_cast<size_t>(MemoryTag::TagCount);
+
+	// plain zero initialized globals, operator new runs during static init
+	MemoryStats::TagStats s_tags[TAG_COUNT];
+	uint32_t s_frameAllocations[TAG_COUNT];
+	uint32_t s_frameBytes[TAG_COUNT];
+	thread_local MemoryTag s_currentTag = MemoryTag::Other;
+
+	uint8_t Log2(size_t value) {
+		uint8_t result = 0;
+		while ((size_t{1} << result) < value) result++;
+		return result;
+	}
+
+	void Charge(MemoryTag tag, size_t size) {
+		const auto index = static_cast<size_t>(tag);
+		MemoryStats::TagStats& stats = s_tags[index];
+		stats.currentBytes += size;
+		stats.peakBytes = std::max(stats.peakBytes, stats.currentBytes);
+		stats.totalAllocations++;
+		s_frameAllocations[index]++;
+		s_frameBytes[index] += static_cast<uint32_t>(size);
+	}
+	void Release(MemoryTag tag, size_t size) {
+		uint64_t& current = s_tags[static_cast<size_t>(tag)].currentBytes;
+		current -= std::min<uint64_t>(size, current);
+	}
+
+#if defined(WASMGAME_MEMORY_STATS) && !defined(WASMGAME_HEADLESS)
+	// bullet and imgui get plain malloc blocks, charged by their usable size. both may
+	// free blocks they got before the hooks were installed, those are valid malloc blocks
+	// too and were never charged, so Release stops at zero
+	void* BulletAlloc(size_t size) {
+		void* ptr = std::malloc(size);
+		if (ptr) Charge(MemoryTag::Physics, malloc_usable_size(ptr));
+		return ptr;
+	}
+	void BulletFree(void* ptr) {
+		if (!ptr) return;
+		Release(MemoryTag::Physics, malloc_usable_size(ptr));
+		std::free(ptr);
+	}
+#ifndef WASMGAME_SLIM
+	void* ImGuiAlloc(size_t size, void*) {
+		void* ptr = std::malloc(size);
+		if (ptr) Charge(MemoryTag::ImGui, malloc_usable_size(ptr));
+		return ptr;
+	}
+	void ImGuiFree(void* ptr, void*) {
+		if (!ptr) return;
+		Release(MemoryTag::ImGui, malloc_usable_size(ptr));
+		std::free(ptr);
+	}
+#endif
+#endif
+}
+
+void* MemoryStats::Allocate(size_t size, size_t alignment) {
+	alignment = std::max<size_t>(alignment, sizeof(BlockHeader));
+	const uint8_t offsetLog2 = Log2(alignment);
+	alignment = size_t{1} << offsetLog2;
+	const size_t total = alignment + ((size + alignment - 1) & ~(alignment - 1));
+
+	auto* raw = static_cast<uint8_t*>(std::aligned_alloc(alignment, total));
+	if (!raw) return nullptr;
+	uint8_t* ptr = raw + alignment;
+
+	const MemoryTag tag = s_currentTag;
+	auto* header = reinterpret_cast<BlockHeader*>(ptr - sizeof(BlockHeader));
+	*header = {static_cast<uint8_t>(tag), offsetLog2, 0, 0, size};
+#ifdef WASMGAME_ALLOC_TRACKING
+	header->site = AllocTracker::OnAllocate(size);
+#endif
+	Charge(tag, size);
+	return ptr;
+}
+void MemoryStats::Free(void* ptr) {
+	if (!ptr) return;
+	const auto* header = reinterpret_cast<const BlockHeader*>(static_cast<uint8_t*>(ptr) - sizeof(BlockHeader));
+#ifdef WASMGAME_ALLOC_TRACKING
+	AllocTracker::OnFree(header->site, header->size);
+#endif
+	Release(static_cast<MemoryTag>(header->tag), header->size);
+	std::free(static_cast<uint8_t*>(ptr) - (size_t{1} << header->offsetLog2));
+}
+MemoryTag MemoryStats::GetCurrentTag() {
+	return s_currentTag;
+}
+void MemoryStats::SetCurrentTag(MemoryTag tag) {
+	s_currentTag = tag;
+}
+
+void MemoryStats::InstallHooks() {
+#if defined(WASMGAME_MEMORY_STATS) && !defined(WASMGAME_HEADLESS)
+	btAlignedAllocSetCustom(BulletAlloc, BulletFree);
+#ifndef WASMGAME_SLIM
+	ImGui::SetAllocatorFunctions(ImGuiAlloc, ImGuiFree);
+#endif
+#endif
+}
+void MemoryStats::EndFrame() {
+	for (size_t i = 0; i < TAG_COUNT; i++) {
+		s_tags[i].allocationsLastFrame = s_frameAllocations[i];
+		s_tags[i].bytesLastFrame = s_frameBytes[i];
+		s_frameAllocations[i] = 0;
+		s_frameBytes[i] = 0;
+	}
+#ifdef WASMGAME_ALLOC_TRACKING
+	AllocTracker::EndFrame();
+#endif
+}
+
+const char* MemoryStats::GetTagName(MemoryTag tag) {
+	switch (tag) {
+	case MemoryTag::Other: return "other";
+	case MemoryTag::Meshes: return "meshes";
+	case MemoryTag::Physics: return "physics";
+	case MemoryTag::Ecs: return "ecs";
+	case MemoryTag::Text: return "text";
+	case MemoryTag::Scripts: return "scripts";
+	case MemoryTag::ImGui: return "imgui";
+	default: return "unknown";
+	}
+}
+MemoryStats::TagStats MemoryStats::GetTagStats(MemoryTag tag) {
+	return s_tags[static_cast<size_t>(tag)];
+}
+MemoryStats::HeapStats MemoryStats::GetHeapStats() {
+	HeapStats stats{};
+#ifdef __EMSCRIPTEN__
+	stats.usedBytes = mallinfo().uordblks;
+	stats.heapBytes = emscripten_get_heap_size();
+	stats.maxHeapBytes = emscripten_get_heap_max();
+#else
+	for (const auto& tag : s_tags) stats.usedBytes += tag.currentBytes;
+	stats.heapBytes = stats.usedBytes;
+	stats.maxHeapBytes = stats.usedBytes;
+#endif
+	return stats;
+}
+
+#if !defined(WASMGAME_SLIM) && !defined(WASMGAME_HEADLESS)
+void MemoryStats::DrawOverlay() {
+	constexpr float MB = 1024.0f * 1024.0f;
+	const auto& io = ImGui::GetIO();
+	ImGui::SetNextWindowPos({io.DisplaySize.x - 10, 10}, ImGuiCond_FirstUseEver, {1, 0});
+	if (ImGui::Begin("Memory", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing)) {
+		const HeapStats heap = GetHeapStats();
+		ImGui::Text("heap %.1f / %.1f MB, limit %.1f MB", heap.usedBytes / MB, heap.heapBytes / MB, heap.maxHeapBytes / MB);
+		if (!TRACKING) {
+			ImGui::TextUnformatted("per subsystem accounting needs -DWASMGAME_MEMORY_STATS=ON");
+		} else if (ImGui::BeginTable("MemoryTags", 4, ImGuiTableFlags_SizingFixedFit)) {
+			ImGui::TableSetupColumn("tag");
+			ImGui::TableSetupColumn("current KB");
+			ImGui::TableSetupColumn("peak KB");
+			ImGui::TableSetupColumn("allocs/frame");
+			ImGui::TableHeadersRow();
+			for (size_t i = 0; i < TAG_COUNT; i++) {
+				const TagStats& stats = s_tags[i];
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(GetTagName(static_cast<MemoryTag>(i)));
+				ImGui::TableNextColumn();
+				ImGui::Text("%.1f", stats.currentBytes / 1024.0f);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.1f", stats.peakBytes / 1024.0f);
+				ImGui::TableNextColumn();
+				ImGui::Text("%u", stats.allocationsLastFrame);
+			}
+			ImGui::EndTable();
+		}
+#ifdef WASMGAME_ALLOC_TRACKING
+		if (!AllocTracker::IsSettled()) {
+			ImGui::TextUnformatted("allocation sites: waiting for the scene to settle");
+		} else if (ImGui::CollapsingHeader("steady state allocation sites")) {
+			const AllocTracker::Site* sites[10];
+			const uint32_t count = AllocTracker::GetSteadySites(sites, 10);
+			ImGui::Text("%u allocations last frame", AllocTracker::GetFrameAllocations());
+			for (uint32_t i = 0; i < count; i++) {
+				ImGui::Separator();
+				ImGui::Text("%.1f allocs/frame, %.1f KB live", AllocTracker::GetAllocationsPerFrame(*sites[i]), sites[i]->liveBytes / 1024.0f);
+				ImGui::TextUnformatted(AllocTracker::DescribeSite(*sites[i]).c_str());
+			}
+		}
+#endif
+	}
+	ImGui::End();
+}
+#endif
+
+#ifdef WASMGAME_MEMORY_STATS
+// global allocation hooks
+void* operator new(size_t size) {
+	void* ptr = MemoryStats::Allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+	if (!ptr) std::abort();
+	return ptr;
+}
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	return MemoryStats::Allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	return MemoryStats::Allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+	void* ptr = MemoryStats::Allocate(size, static_cast<size_t>(alignment));
+	if (!ptr) std::abort();
+	return ptr;
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+	return operator new(size, alignment);
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	return MemoryStats::Allocate(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	return MemoryStats::Allocate(size, static_cast<size_t>(alignment));
+}
+void operator delete(void* ptr) noexcept { MemoryStats::Free(ptr); }
+void operator delete[](void* ptr) noexcept { MemoryStats::Free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { MemoryStats::Free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { MemoryStats::Free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { MemoryStats::Free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { MemoryStats::Free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { MemoryStats::Free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { MemoryStats::Free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { MemoryStats::Free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { MemoryStats::Free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { MemoryStats::Free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { MemoryStats::Free(ptr); }
+#endif
+
+#ifdef __EMSCRIPTEN__
+emscripten::val getMemoryStats() {
+	const MemoryStats::HeapStats heap = MemoryStats::GetHeapStats();
+	emscripten::val result = emscripten::val::object();
+	result.set("heapUsed", static_cast<double>(heap.usedBytes));
+	result.set("heapSize", static_cast<double>(heap.heapBytes));
+	result.set("heapMax", static_cast<double>(heap.maxHeapBytes));
+
+	emscripten::val tags = emscripten::val::object();
+	for (size_t i = 0; i < TAG_COUNT; i++) {
+		const auto tag = static_cast<MemoryTag>(i);
+		const MemoryStats::TagStats stats = MemoryStats::GetTagStats(tag);
+		emscripten::val tagStats = emscripten::val::object();
+		tagStats.set("currentBytes", static_cast<double>(stats.currentBytes));
+		tagStats.set("peakBytes", static_cast<double>(stats.peakBytes));
+		tagStats.set("totalAllocations", static_cast<double>(stats.totalAllocations));
+		tagStats.set("allocationsLastFrame", stats.allocationsLastFrame);
+		tagStats.set("bytesLastFrame", stats.bytesLastFrame);
+		tags.set(MemoryStats::GetTagName(tag), tagStats);
+	}
+	result.set("tags", tags);
+	return result;
+}
+
+EMSCRIPTEN_BINDINGS(memory_stats) {
+	emscripten::function("getMemoryStats", &getMemoryStats);
+}
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// heap accounting per subsystem, compiled into debug builds and -DWASMGAME_MEMORY_STATS=ON.
+// global operator new/delete, bullet and imgui allocations are routed through here and
+// charged to the tag active at the time. other builds only report the wasm heap.
+enum class MemoryTag : uint8_t {
+	Other,
+	Meshes,
+	Physics,
+	Ecs,
+	Text,
+	Scripts,
+	ImGui,
+	TagCount,
+};
+
+namespace MemoryStats {
+#ifdef WASMGAME_MEMORY_STATS
+	constexpr bool TRACKING = true;
+#else
+	constexpr bool TRACKING = false;
+#endif
+
+	struct TagStats {
+		uint64_t currentBytes;
+		uint64_t peakBytes;
+		uint64_t totalAllocations;
+		uint32_t allocationsLastFrame;
+		uint32_t bytesLastFrame;
+	};
+	struct HeapStats {
+		uint64_t usedBytes;   // handed out by malloc
+		uint64_t heapBytes;   // current wasm memory size
+		uint64_t maxHeapBytes; // limit the memory can grow to
+	};
+
+	// routes bullet and imgui allocations through the tracker, call before creating any scene.
+	// does nothing unless tracking is compiled in
+	void InstallHooks();
+	// closes the per frame counters
+	void EndFrame();
+
+	const char* GetTagName(MemoryTag tag);
+	TagStats GetTagStats(MemoryTag tag);
+	HeapStats GetHeapStats();
+
+#ifndef WASMGAME_SLIM
+	// ImGui window shown next to the CTRL+U metrics
+	void DrawOverlay();
+#endif
+
+	// used by the allocation hooks. Free takes blocks from Allocate only
+	void* Allocate(size_t size, size_t alignment);
+	void Free(void* ptr);
+	MemoryTag GetCurrentTag();
+	void SetCurrentTag(MemoryTag tag);
+}
+
+// charges allocations made in this scope to a tag
+class MemoryTagScope {
+public:
+	explicit MemoryTagScope(MemoryTag tag) : m_previous(MemoryStats::GetCurrentTag()) {
+		MemoryStats::SetCurrentTag(tag);
+	}
+	~MemoryTagScope() { MemoryStats::SetCurrentTag(m_previous); }
+	MemoryTagScope(const MemoryTagScope&) = delete;
+	MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+private:
+	MemoryTag m_previous;
+};
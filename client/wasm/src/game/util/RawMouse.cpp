@@ -0,0 +1,85 @@
+#include "RawMouse.h"
+
+#include <algorithm>
+#include <array>
+#include <emscripten/bind.h>
+#include <emscripten/html5.h>
+#include <stdint.h>
+
+#ifndef WASMGAME_SLIM
+#include <wgleng/vendor/imgui/imgui.h>
+#endif
+
+namespace {
+	constexpr uint32_t SAMPLE_COUNT = 120;
+
+	glm::vec2 s_delta{0};
+	double s_oldestEventTime = 0; // first event not consumed yet, 0 if none
+	double s_consumedEventTime = 0; // oldest event the current frame used
+	std::array<float, SAMPLE_COUNT> s_samples{};
+	uint32_t s_sampleCount = 0;
+	uint32_t s_sampleIndex = 0;
+	float s_p50 = 0;
+	float s_p90 = 0;
+
+	EM_BOOL OnMouseMove(int, const EmscriptenMouseEvent* event, void*) {
+		s_delta.x += static_cast<float>(event->movementX);
+		s_delta.y += static_cast<float>(event->movementY);
+		if (s_oldestEventTime == 0) s_oldestEventTime = emscripten_get_now();
+		// let sdl see the event too
+		return EM_FALSE;
+	}
+
+	void UpdatePercentiles() {
+		std::array<float, SAMPLE_COUNT> sorted = s_samples;
+		const auto end = sorted.begin() + s_sampleCount;
+		std::nth_element(sorted.begin(), sorted.begin() + s_sampleCount / 2, end);
+		s_p50 = sorted[s_sampleCount / 2];
+		std::nth_element(sorted.begin(), sorted.begin() + s_sampleCount * 9 / 10, end);
+		s_p90 = sorted[s_sampleCount * 9 / 10];
+	}
+}
+
+void RawMouse::Install() {
+	emscripten_set_mousemove_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, nullptr, EM_FALSE, OnMouseMove);
+}
+
+void RawMouse::BeginFrame() {
+	if (s_consumedEventTime == 0) return;
+	// the previous frame was presented by the time this one starts
+	s_samples[s_sampleIndex] = static_cast<float>(emscripten_get_now() - s_consumedEventTime);
+	s_sampleIndex = (s_sampleIndex + 1) % SAMPLE_COUNT;
+	s_sampleCount = std::min(s_sampleCount + 1, SAMPLE_COUNT);
+	s_consumedEventTime = 0;
+	if (s_sampleIndex % 10 == 0) UpdatePercentiles();
+}
+
+glm::vec2 RawMouse::Consume() {
+	const glm::vec2 delta = s_delta;
+	s_delta = glm::vec2{0};
+	if (s_oldestEventTime != 0) s_consumedEventTime = s_oldestEventTime;
+	s_oldestEventTime = 0;
+	return delta;
+}
+
+float RawMouse::GetLatencyP50() {
+	return s_p50;
+}
+float RawMouse::GetLatencyP90() {
+	return s_p90;
+}
+
+#ifndef WASMGAME_SLIM
+void RawMouse::DrawOverlay() {
+	const auto& io = ImGui::GetIO();
+	ImGui::SetNextWindowPos({10, io.DisplaySize.y - 10}, ImGuiCond_FirstUseEver, {0, 1});
+	if (ImGui::Begin("Input", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing)) {
+		ImGui::Text("mouse to photon p50 %.1f ms, p90 %.1f ms", s_p50, s_p90);
+	}
+	ImGui::End();
+}
+#endif
+
+EMSCRIPTEN_BINDINGS(raw_mouse) {
+	emscripten::function("getInputLatency", &RawMouse::GetLatencyP50);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// relative mouse motion summed from every mousemove event (movementX/Y, like pointer lock),
+// instead of sampling the cursor position once per tick. also measures how old input is when
+// the frame that used it starts being shown.
+namespace RawMouse {
+	void Install();
+	// call first thing each frame, closes the latency sample of the last consumed input
+	void BeginFrame();
+	// motion since the last call, in css pixels
+	glm::vec2 Consume();
+
+	float GetLatencyP50();
+	float GetLatencyP90();
+#ifndef WASMGAME_SLIM
+	// ImGui window shown with the CTRL+U metrics
+	void DrawOverlay();
+#endif
+}
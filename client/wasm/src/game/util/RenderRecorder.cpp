@@ -0,0 +1,236 @@
+#include "RenderRecorder.h"
+
+#include <algorithm>
+
+#if !defined(WASMGAME_SLIM) && !defined(WASMGAME_HEADLESS)
+#include <wgleng/vendor/imgui/imgui.h>
+#endif
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/bind.h>
+#include <emscripten/emscripten.h>
+#endif
+
+namespace {
+	using namespace RenderRecorder;
+
+	constexpr uint32_t GL_TRIANGLES = 0x0004;
+	constexpr uint32_t GL_TRIANGLE_STRIP = 0x0005;
+	constexpr uint32_t GL_TRIANGLE_FAN = 0x0006;
+	// binding points tracked per call, buffer targets and texture units. more are counted, never redundant
+	constexpr uint32_t BINDING_CAPACITY = 32;
+
+	struct Binding {
+		uint32_t target;
+		uint32_t object;
+	};
+	struct Bindings {
+		Binding slots[BINDING_CAPACITY];
+		uint32_t count;
+	};
+
+	FrameStats s_frame{};
+	FrameStats s_lastFrame{};
+	// what the context has bound, kept across frames like the gl state itself
+	Bindings s_bindings[CALL_COUNT]{};
+	bool s_enabled = false;
+
+	uint64_t CountTriangles(uint32_t mode, uint32_t count) {
+		switch (mode) {
+		case GL_TRIANGLES: return count / 3;
+		case GL_TRIANGLE_STRIP:
+		case GL_TRIANGLE_FAN: return count >= 3 ? count - 2 : 0;
+		default: return 0;
+		}
+	}
+	// true if the object was bound to the target already
+	bool Bind(Bindings& bindings, uint32_t target, uint32_t object) {
+		for (uint32_t i = 0; i < bindings.count; i++) {
+			Binding& binding = bindings.slots[i];
+			if (binding.target != target) continue;
+			const bool same = binding.object == object;
+			binding.object = object;
+			return same;
+		}
+		if (bindings.count < BINDING_CAPACITY) bindings.slots[bindings.count++] = {target, object};
+		return false;
+	}
+	void Append(std::string& out, const char* name, uint64_t value) {
+		out += ' ';
+		out += name;
+		out += '=';
+		out += std::to_string(value);
+	}
+}
+
+void RenderRecorder::SetEnabled(bool enabled) {
+	if (s_enabled == enabled) return;
+	s_enabled = enabled;
+	// whatever was bound while disabled is unknown
+	std::fill(std::begin(s_bindings), std::end(s_bindings), Bindings{});
+	s_frame = {};
+#ifdef __EMSCRIPTEN__
+	EM_ASM({
+		Module['renderRecording'] = !!$0;
+	}, enabled);
+#endif
+}
+bool RenderRecorder::IsEnabled() {
+	return s_enabled;
+}
+
+void RenderRecorder::RecordBind(Call call, uint32_t target, uint32_t object) {
+	if (!s_enabled) return;
+	const auto index = static_cast<size_t>(call);
+	s_frame.calls[index]++;
+	if (Bind(s_bindings[index], target, object)) s_frame.redundant[index]++;
+}
+void RenderRecorder::RecordDraw(uint32_t mode, uint32_t count, uint32_t instances) {
+	if (!s_enabled) return;
+	s_frame.calls[static_cast<size_t>(Call::Draw)]++;
+	s_frame.triangles += CountTriangles(mode, count) * std::max<uint32_t>(instances, 1);
+}
+void RenderRecorder::RecordUniform() {
+	if (!s_enabled) return;
+	s_frame.calls[static_cast<size_t>(Call::Uniform)]++;
+}
+void RenderRecorder::RecordUpload(uint64_t bytes) {
+	if (!s_enabled) return;
+	s_frame.calls[static_cast<size_t>(Call::Upload)]++;
+	s_frame.uploadBytes += bytes;
+}
+void RenderRecorder::EndFrame() {
+	s_lastFrame = s_frame;
+	s_frame = {};
+}
+
+const RenderRecorder::FrameStats& RenderRecorder::GetFrameStats() {
+	return s_lastFrame;
+}
+const char* RenderRecorder::GetCallName(Call call) {
+	switch (call) {
+	case Call::Draw: return "draw";
+	case Call::UseProgram: return "useProgram";
+	case Call::BindVertexArray: return "bindVertexArray";
+	case Call::BindBuffer: return "bindBuffer";
+	case Call::BindTexture: return "bindTexture";
+	case Call::BindFramebuffer: return "bindFramebuffer";
+	case Call::Uniform: return "uniform";
+	case Call::Upload: return "upload";
+	default: return "unknown";
+	}
+}
+
+std::string RenderRecorder::Summarize() {
+	const FrameStats& stats = s_lastFrame;
+	std::string result = "frame";
+	Append(result, "draws", stats.calls[static_cast<size_t>(Call::Draw)]);
+	Append(result, "triangles", stats.triangles);
+	Append(result, "uploadBytes", stats.uploadBytes);
+	result += '\n';
+	for (size_t i = 0; i < CALL_COUNT; i++) {
+		result += GetCallName(static_cast<Call>(i));
+		Append(result, "calls", stats.calls[i]);
+		Append(result, "redundant", stats.redundant[i]);
+		result += '\n';
+	}
+	return result;
+}
+
+#if !defined(WASMGAME_SLIM) && !defined(WASMGAME_HEADLESS)
+void RenderRecorder::DrawOverlay() {
+	const FrameStats& stats = s_lastFrame;
+	const auto& io = ImGui::GetIO();
+	ImGui::SetNextWindowPos({io.DisplaySize.x - 10, io.DisplaySize.y - 10}, ImGuiCond_FirstUseEver, {1, 1});
+	if (ImGui::Begin("Render", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing)) {
+		ImGui::Text("triangles %llu, uploads %.1f KB", static_cast<unsigned long long>(stats.triangles),
+			stats.uploadBytes / 1024.0f);
+		if (ImGui::BeginTable("RenderCalls", 3, ImGuiTableFlags_SizingFixedFit)) {
+			ImGui::TableSetupColumn("gl call");
+			ImGui::TableSetupColumn("per frame");
+			ImGui::TableSetupColumn("redundant");
+			ImGui::TableHeadersRow();
+			for (size_t i = 0; i < CALL_COUNT; i++) {
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(GetCallName(static_cast<Call>(i)));
+				ImGui::TableNextColumn();
+				ImGui::Text("%u", stats.calls[i]);
+				ImGui::TableNextColumn();
+				ImGui::Text("%u", stats.redundant[i]);
+			}
+			ImGui::EndTable();
+		}
+	}
+	ImGui::End();
+}
+#endif
+
+#ifdef __EMSCRIPTEN__
+extern "C" {
+	EMSCRIPTEN_KEEPALIVE void renderRecorderBind(uint32_t call, uint32_t target, uint32_t object) {
+		RenderRecorder::RecordBind(static_cast<Call>(call), target, object);
+	}
+	EMSCRIPTEN_KEEPALIVE void renderRecorderDraw(uint32_t mode, uint32_t count, uint32_t instances) {
+		RenderRecorder::RecordDraw(mode, count, instances);
+	}
+	EMSCRIPTEN_KEEPALIVE void renderRecorderUniform() {
+		RenderRecorder::RecordUniform();
+	}
+	EMSCRIPTEN_KEEPALIVE void renderRecorderUpload(double bytes) {
+		RenderRecorder::RecordUpload(static_cast<uint64_t>(bytes));
+	}
+}
+
+void RenderRecorder::Install() {
+	// emscripten gives every gl object a numeric name. the hooks only call into
+	// the module while recording, so an idle recorder costs a flag check per call
+	EM_ASM({
+		const gl = GLctx;
+		if (!gl || gl['renderRecorderInstalled']) return;
+		gl['renderRecorderInstalled'] = true;
+		const name = function(object) { return object ? object['name'] : 0; };
+		const wrap = function(method, record) {
+			const original = gl[method];
+			if (!original) return;
+			gl[method] = function() {
+				if (Module['renderRecording']) record.apply(null, arguments);
+				return original.apply(gl, arguments);
+			};
+		};
+		let textureUnit = 0;
+		wrap('activeTexture', function(unit) { textureUnit = unit; });
+		wrap('useProgram', function(program) { _renderRecorderBind($0, 0, name(program)); });
+		wrap('bindVertexArray', function(vao) { _renderRecorderBind($1, 0, name(vao)); });
+		wrap('bindBuffer', function(target, buffer) { _renderRecorderBind($2, target, name(buffer)); });
+		wrap('bindTexture', function(target, texture) { _renderRecorderBind($3, textureUnit * 65536 + target, name(texture)); });
+		wrap('bindFramebuffer', function(target, framebuffer) { _renderRecorderBind($4, target, name(framebuffer)); });
+		wrap('drawArrays', function(mode, first, count) { _renderRecorderDraw(mode, count, 1); });
+		wrap('drawElements', function(mode, count) { _renderRecorderDraw(mode, count, 1); });
+		wrap('drawArraysInstanced', function(mode, first, count, instances) { _renderRecorderDraw(mode, count, instances); });
+		wrap('drawElementsInstanced', function(mode, count, type, offset, instances) { _renderRecorderDraw(mode, count, instances); });
+		// webgl2 overloads pass the heap and a byte length as the 5th argument
+		const bufferBytes = function(data, length) {
+			if (length !== undefined) return length;
+			return typeof data == 'number' ? data : (data ? data.byteLength : 0);
+		};
+		wrap('bufferData', function(target, data, usage, offset, length) { _renderRecorderUpload(bufferBytes(data, length)); });
+		wrap('bufferSubData', function(target, dstOffset, data, offset, length) { _renderRecorderUpload(bufferBytes(data, length)); });
+		wrap('texImage2D', function() { _renderRecorderUpload(0); });
+		wrap('texSubImage2D', function() { _renderRecorderUpload(0); });
+		for (const method in gl) {
+			if (method.startsWith('uniform') && method != 'uniformBlockBinding' && typeof gl[method] == 'function') {
+				wrap(method, function() { _renderRecorderUniform(); });
+			}
+		}
+	}, static_cast<uint32_t>(Call::UseProgram), static_cast<uint32_t>(Call::BindVertexArray), static_cast<uint32_t>(Call::BindBuffer),
+		static_cast<uint32_t>(Call::BindTexture), static_cast<uint32_t>(Call::BindFramebuffer));
+}
+
+EMSCRIPTEN_BINDINGS(render_recorder) {
+	emscripten::function("setRenderRecording", &RenderRecorder::SetEnabled);
+	emscripten::function("getRenderSummary", &RenderRecorder::Summarize);
+}
+#else
+void RenderRecorder::Install() {}
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+// counts the gl calls the engine makes per frame. Install wraps the webgl context, so
+// draws, binds, uniforms and uploads are what the renderer actually submits, and binds
+// of what was already bound are counted as redundant. the counting itself is engine
+// independent, the headless tests feed it directly.
+namespace RenderRecorder {
+	enum class Call : uint8_t {
+		Draw,
+		UseProgram,
+		BindVertexArray,
+		BindBuffer,
+		BindTexture,
+		BindFramebuffer,
+		Uniform,
+		Upload,
+		CallCount,
+	};
+	constexpr size_t CALL_COUNT = static_cast<size_t>(Call::CallCount);
+
+	struct FrameStats {
+		uint32_t calls[CALL_COUNT];
+		uint32_t redundant[CALL_COUNT]; // binds of the object already bound to the target
+		uint64_t triangles;
+		uint64_t uploadBytes;
+	};
+
+	// wraps the gl context, call once after the engine created it
+	void Install();
+	void SetEnabled(bool enabled);
+	bool IsEnabled();
+
+	// called by the gl hooks. target tells apart binding points, like buffer targets
+	// or texture units, object is the gl name, 0 for unbinding
+	void RecordBind(Call call, uint32_t target, uint32_t object);
+	void RecordDraw(uint32_t mode, uint32_t count, uint32_t instances);
+	void RecordUniform();
+	void RecordUpload(uint64_t bytes);
+	// closes the frame, GetFrameStats returns it from then on
+	void EndFrame();
+
+	const FrameStats& GetFrameStats();
+	const char* GetCallName(Call call);
+	// stable text summary of the last frame, diffable between builds
+	std::string Summarize();
+
+#ifndef WASMGAME_SLIM
+	// ImGui window shown next to the CTRL+U metrics
+	void DrawOverlay();
+#endif
+}
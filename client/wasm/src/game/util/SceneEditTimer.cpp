@@ -0,0 +1,66 @@
+#include "SceneEditTimer.h"
+
+// the editor exists in shader hot reload builds only, nothing here is linked elsewhere
+#ifdef SHADER_HOT_RELOAD
+#include <wgleng/core/Components.h>
+#include <wgleng/vendor/imgui/imgui.h>
+
+SceneEditTimer::SceneEditTimer(entt::registry& registry)
+	: m_registry(registry) {
+	m_registry.on_construct<TransformComponent>().connect<&SceneEditTimer::OnConstruct>(*this);
+	m_registry.on_update<TransformComponent>().connect<&SceneEditTimer::OnUpdate>(*this);
+	m_registry.on_destroy<TransformComponent>().connect<&SceneEditTimer::OnDestroy>(*this);
+}
+SceneEditTimer::~SceneEditTimer() {
+	m_registry.on_construct<TransformComponent>().disconnect<&SceneEditTimer::OnConstruct>(*this);
+	m_registry.on_update<TransformComponent>().disconnect<&SceneEditTimer::OnUpdate>(*this);
+	m_registry.on_destroy<TransformComponent>().disconnect<&SceneEditTimer::OnDestroy>(*this);
+}
+
+void SceneEditTimer::Begin() {
+	m_created = m_updated = m_destroyed = 0;
+	m_measuring = true;
+	m_start = TimePoint();
+}
+void SceneEditTimer::End() {
+	m_measuring = false;
+	// frames without changes are not edits
+	if (m_created + m_updated + m_destroyed == 0) return;
+
+	m_lastEditMs = (TimePoint() - m_start).fMilli();
+	m_totalEditMs += m_lastEditMs;
+	m_edits++;
+	m_lastCreated = m_created;
+	m_lastUpdated = m_updated;
+	m_lastDestroyed = m_destroyed;
+	// the builder's entities, the player is not part of the scene
+	m_lastSceneSize = 0;
+	for ([[maybe_unused]] const auto entity : m_registry.view<TransformComponent>(entt::exclude<PlayerComponent>)) m_lastSceneSize++;
+}
+
+void SceneEditTimer::OnConstruct(entt::registry&, entt::entity) {
+	if (m_measuring) m_created++;
+}
+void SceneEditTimer::OnUpdate(entt::registry&, entt::entity) {
+	if (m_measuring) m_updated++;
+}
+void SceneEditTimer::OnDestroy(entt::registry&, entt::entity) {
+	if (m_measuring) m_destroyed++;
+}
+
+void SceneEditTimer::DrawOverlay() const {
+	ImGui::SetNextWindowPos({10, 10}, ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("Scene edits", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing)) {
+		if (m_edits == 0) {
+			ImGui::TextUnformatted("no edits applied yet");
+		} else {
+			ImGui::Text("last edit %.2f ms, average %.2f ms over %u edits", m_lastEditMs, m_totalEditMs / m_edits, m_edits);
+			ImGui::Text("entities created %u, updated %u, destroyed %u", m_lastCreated, m_lastUpdated, m_lastDestroyed);
+			// a full rebuild creates or updates every entity of the scene
+			const bool full = m_lastCreated + m_lastUpdated >= m_lastSceneSize;
+			ImGui::Text("scene has %zu entities, %s", m_lastSceneSize, full ? "the edit rebuilt all of them" : "the edit touched part of it");
+		}
+	}
+	ImGui::End();
+}
+#endif
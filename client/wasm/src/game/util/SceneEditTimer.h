@@ -0,0 +1,45 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <stdint.h>
+#include <wgleng/util/Timer.h>
+
+// editor builds only. times SceneBuilder::Update and counts the entities it touched.
+// the engine's builder re-applies every state on an edit, so the time is that of a full
+// rebuild. the overlay says whether an edit touched the whole scene, a builder that
+// applies only the changed states shows up as edits that touch a few entities.
+class SceneEditTimer {
+public:
+	explicit SceneEditTimer(entt::registry& registry);
+	~SceneEditTimer();
+	SceneEditTimer(const SceneEditTimer&) = delete;
+	SceneEditTimer& operator=(const SceneEditTimer&) = delete;
+
+	// around the scene builder update
+	void Begin();
+	void End();
+
+	void DrawOverlay() const;
+
+private:
+	void OnConstruct(entt::registry& registry, entt::entity entity);
+	void OnUpdate(entt::registry& registry, entt::entity entity);
+	void OnDestroy(entt::registry& registry, entt::entity entity);
+
+	entt::registry& m_registry;
+	TimePoint m_start;
+	bool m_measuring = false;
+
+	uint32_t m_created = 0;
+	uint32_t m_updated = 0;
+	uint32_t m_destroyed = 0;
+
+	// last applied edit
+	uint32_t m_edits = 0;
+	float m_lastEditMs = 0;
+	float m_totalEditMs = 0;
+	uint32_t m_lastCreated = 0;
+	uint32_t m_lastUpdated = 0;
+	uint32_t m_lastDestroyed = 0;
+	size_t m_lastSceneSize = 0;
+};
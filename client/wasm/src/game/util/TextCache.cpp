@@ -0,0 +1,40 @@
+#include "TextCache.h"
+
+#include <functional>
+#include <iterator>
+
+size_t TextCache::KeyHash::operator()(const KeyView& key) const {
+	const size_t hash = std::hash<std::string_view>{}(key.text);
+	return hash ^ (std::hash<std::string_view>{}(key.font) + 0x9e3779b9 + (hash << 6) + (hash >> 2)) ^ key.wrap;
+}
+
+std::shared_ptr<DrawableText> TextCache::Get(std::string_view font, std::string_view text, uint32_t wrap) {
+	auto it = m_entries.find(KeyView{font, text, wrap});
+	if (it != m_entries.end()) {
+		for (auto& instance : it->second) {
+			if (instance.lastUsedFrame == m_frame) continue;
+			instance.lastUsedFrame = m_frame;
+			return instance.drawable;
+		}
+	} else {
+		it = m_entries.emplace(Key{std::string(font), std::string(text), wrap}, std::vector<Instance>{}).first;
+	}
+
+	std::shared_ptr<DrawableText> drawable = wrap ? Text::CreateText(std::string(font), std::string(text), wrap)
+		: Text::CreateText(std::string(font), std::string(text));
+	m_created++;
+	it->second.push_back({drawable, m_frame});
+	return drawable;
+}
+
+void TextCache::EndFrame(uint32_t maxUnusedFrames) {
+	for (auto it = m_entries.begin(); it != m_entries.end();) {
+		std::erase_if(it->second, [&](const Instance& instance) {
+			return m_frame - instance.lastUsedFrame > maxUnusedFrames;
+		});
+		it = it->second.empty() ? m_entries.erase(it) : std::next(it);
+	}
+	m_createdLastFrame = m_created;
+	m_created = 0;
+	m_frame++;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <wgleng/core/Scene.h>
+
+// reuses DrawableTexts whose font and string did not change, so per frame HUD text
+// only builds glyph geometry when it actually changes. lookups hash the font, text and
+// wrap width without building a key. one cache per owner, the returned texts are
+// positioned by the caller every frame. every text is still its own engine draw,
+// merging them into one glyph atlas batch needs the engine's text renderer.
+class TextCache {
+public:
+	// same text twice in one frame gets two instances
+	std::shared_ptr<DrawableText> Get(std::string_view font, std::string_view text, uint32_t wrap = 0);
+	// drops texts not used for a while
+	void EndFrame(uint32_t maxUnusedFrames = 120);
+
+	uint32_t GetCreatedLastFrame() const { return m_createdLastFrame; }
+
+private:
+	struct KeyView {
+		std::string_view font;
+		std::string_view text;
+		uint32_t wrap;
+	};
+	struct Key {
+		std::string font;
+		std::string text;
+		uint32_t wrap;
+
+		operator KeyView() const { return {font, text, wrap}; }
+	};
+	struct KeyHash {
+		using is_transparent = void;
+		size_t operator()(const KeyView& key) const;
+		size_t operator()(const Key& key) const { return (*this)(KeyView(key)); }
+	};
+	struct KeyEqual {
+		using is_transparent = void;
+		bool operator()(const KeyView& lhs, const KeyView& rhs) const {
+			return lhs.wrap == rhs.wrap && lhs.text == rhs.text && lhs.font == rhs.font;
+		}
+	};
+	struct Instance {
+		std::shared_ptr<DrawableText> drawable;
+		uint32_t lastUsedFrame;
+	};
+
+	std::unordered_map<Key, std::vector<Instance>, KeyHash, KeyEqual> m_entries;
+	uint32_t m_frame = 1;
+	uint32_t m_created = 0;
+	uint32_t m_createdLastFrame = 0;
+};
@@ -1,27 +1,79 @@
+#include <emscripten/bind.h>
 #include <wgleng/core/EntryPoint.h>
 #include <wgleng/io/Input.h>
-#include <wgleng/rendering/Debug.h>
-#include <wgleng/vendor/imgui/imgui.h>
 
 #include "game/GameScene.h"
+#include "game/InputReplay.h"
+#include "game/Levels.h"
 #include "game/ModelInit.h"
+#include "game/QualityGovernor.h"
+#include "game/RunLevel.h"
 #include "game/SettingsScreen.h"
+#include "game/Telemetry.h"
+#include "game/util/MemoryStats.h"
+#include "game/util/RawMouse.h"
+#include "game/util/RenderRecorder.h"
 #include "wgleng/util/Metrics.h"
 
+// slim release builds leave benchmarks, debug keys and ImGui overlays out of the module
+#ifndef WASMGAME_SLIM
+#include <wgleng/rendering/Debug.h>
+
+#include "game/GameBenchmarks.h"
+#endif
+
 WGLENG_INIT_ENGINE
 
+QualityGovernor* qualityGovernor;
 SettingsScreen* settingsScreen;
+bool restartRequested = false;
+
+void restart() {
+	restartRequested = true;
+}
+EMSCRIPTEN_BINDINGS(game_main) {
+	emscripten::function("restart", &restart);
+}
 
 void onInit(Context* ctx) {
-	settingsScreen = new SettingsScreen();
-	ctx->scene = std::make_shared<GameScene>();
+	MemoryStats::InstallHooks();
+	RenderRecorder::Install();
+	RawMouse::Install();
+	RunLevels::Install();
+	qualityGovernor = new QualityGovernor();
+	settingsScreen = new SettingsScreen(*qualityGovernor);
+	ctx->scene = Levels::Rebuild();
 }
 void onDeinit(Context* ctx) {
+	Levels::Shutdown();
 	ctx->scene.reset();
 	delete settingsScreen;
 	settingsScreen = nullptr;
+	delete qualityGovernor;
+	qualityGovernor = nullptr;
 }
 void onTick(Context* ctx, TimeDuration dt) {
+	MemoryStats::EndFrame();
+	// the gl calls of the frame rendered after the last tick
+	RenderRecorder::EndFrame();
+	RawMouse::BeginFrame();
+	RunLevels::Update();
+#ifndef WASMGAME_SLIM
+	RunPendingBenchmarks(dt);
+#endif
+	if (restartRequested) {
+		restartRequested = false;
+		// in place when possible, a rebuild reloads meshes and fetches hints again
+		if (!static_cast<GameScene&>(*ctx->scene).Restart()) {
+			ctx->scene = Levels::Rebuild();
+		}
+	}
+	if (!RunPendingReplay(static_cast<GameScene&>(*ctx->scene))) {
+		ctx->scene = Levels::Rebuild();
+	}
+	Levels::Update(ctx->scene, dt);
+
+#ifndef WASMGAME_SLIM
 	// debug input
 	if (Input::IsHeld(SDL_SCANCODE_LCTRL)) {
 		if (Input::JustPressed(SDL_SCANCODE_P)) {
@@ -32,18 +84,31 @@ void onTick(Context* ctx, TimeDuration dt) {
 			else DebugDraw::Enable();
 		}
 		if (Input::JustPressed(SDL_SCANCODE_I)) {
-			const bool show = !ctx->renderer.IsWireframeShown();
-			ctx->renderer.ShowWireframe(show);
-			ReloadModels(show);
+			ShowWireframe(ctx->renderer, !ctx->renderer.IsWireframeShown());
 		}
 		if (Input::JustPressed(SDL_SCANCODE_U)) {
 			if (Metrics::IsEnabled(Metric::ALL_METRICS)) Metrics::Disable(Metric::ALL_METRICS);
 			else Metrics::Enable(Metric::ALL_METRICS);
+			RenderRecorder::SetEnabled(Metrics::IsEnabled(Metric::ALL_METRICS));
 		}
-	} else {
-		if (Input::JustPressed(SDL_SCANCODE_P)) {
-			settingsScreen->SetShown(!settingsScreen->IsShown());
+		if (Input::JustPressed(SDL_SCANCODE_B)) {
+			RequestBenchmarks();
 		}
 	}
-	settingsScreen->Draw(&ctx->renderer);
+#endif
+	if (!Input::IsHeld(SDL_SCANCODE_LCTRL) && Input::JustPressed(SDL_SCANCODE_P)) {
+		settingsScreen->SetShown(!settingsScreen->IsShown());
+	}
+	// throttled frame times say nothing about render cost
+	if (RunLevels::Get() == RunLevel::Full) qualityGovernor->Update(ctx->renderer, dt);
+	Telemetry::Update(dt, ctx->renderer.GetSettings(), *qualityGovernor);
+	settingsScreen->Draw(&ctx->renderer, *ctx->scene);
+#ifndef WASMGAME_SLIM
+	if (Metrics::IsEnabled(Metric::ALL_METRICS)) {
+		MemoryStats::DrawOverlay();
+		RenderRecorder::DrawOverlay();
+		RawMouse::DrawOverlay();
+		Telemetry::DrawOverlay();
+	}
+#endif
 }
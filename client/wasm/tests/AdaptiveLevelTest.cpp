@@ -0,0 +1,97 @@
+#include <cstdint>
+
+#include "Check.h"
+#include "util/AdaptiveLevel.h"
+
+namespace {
+	constexpr uint32_t LEVELS = 4;
+	constexpr float SLOW_MS = 30.0f;
+	constexpr float FAST_MS = 10.0f;
+
+	// frames until the level changes, or limit if it does not
+	uint32_t RunUntilChange(AdaptiveLevel& adaptive, float ms, uint32_t limit) {
+		for (uint32_t i = 1; i <= limit; i++) {
+			if (adaptive.AddFrame(ms)) return i;
+		}
+		return limit;
+	}
+
+	void StepsDownWhenSlow() {
+		AdaptiveLevel adaptive;
+		adaptive.SetLevelCount(LEVELS);
+		// a full window of samples first
+		const uint32_t frames = RunUntilChange(adaptive, SLOW_MS, 1000);
+		CHECK(frames >= 120 && frames < 1000);
+		CHECK(adaptive.GetLevel() == 1);
+		CHECK(adaptive.GetFrameTimeP90() == SLOW_MS);
+
+		// and never past the last level
+		for (uint32_t i = 0; i < 10000; i++) adaptive.AddFrame(SLOW_MS);
+		CHECK(adaptive.GetLevel() == LEVELS - 1);
+	}
+
+	void StaysWithinBudget() {
+		AdaptiveLevel adaptive;
+		adaptive.SetLevelCount(LEVELS);
+		// 18 ms is over 60 fps, but within the step down hysteresis
+		CHECK(RunUntilChange(adaptive, 18.0f, 5000) == 5000);
+		CHECK(adaptive.GetLevel() == 0);
+	}
+
+	void IgnoresHitches() {
+		AdaptiveLevel adaptive;
+		adaptive.SetLevelCount(LEVELS);
+		for (uint32_t i = 0; i < 2000; i++) adaptive.AddFrame(i % 10 == 0 ? 1000.0f : FAST_MS);
+		CHECK(adaptive.GetLevel() == 0);
+	}
+
+	void StepsUpAfterDelay() {
+		AdaptiveLevel adaptive;
+		adaptive.SetLevelCount(LEVELS);
+		RunUntilChange(adaptive, SLOW_MS, 1000);
+		CHECK(adaptive.GetLevel() == 1);
+
+		// 5 s within budget at 10 ms a frame
+		const uint32_t frames = RunUntilChange(adaptive, FAST_MS, 5000);
+		CHECK(frames >= 500 && frames < 600);
+		CHECK(adaptive.GetLevel() == 0);
+	}
+
+	void BacksOffAfterFailedStepUp() {
+		AdaptiveLevel adaptive;
+		adaptive.SetLevelCount(LEVELS);
+		RunUntilChange(adaptive, SLOW_MS, 1000);
+		RunUntilChange(adaptive, FAST_MS, 5000);
+		CHECK(adaptive.GetLevel() == 0);
+		const float delay = adaptive.GetStepUpDelay();
+
+		// level 0 can not hold the target right after stepping up
+		RunUntilChange(adaptive, SLOW_MS, 1000);
+		CHECK(adaptive.GetLevel() == 1);
+		CHECK(adaptive.GetStepUpDelay() == delay * 2.0f);
+		const uint32_t frames = RunUntilChange(adaptive, FAST_MS, 5000);
+		CHECK(frames >= 1000 && frames < 1100);
+
+		// a new ceiling starts over
+		adaptive.SetLevelCount(LEVELS);
+		CHECK(adaptive.GetLevel() == 0);
+		CHECK(adaptive.GetStepUpDelay() == delay);
+	}
+
+	void SingleLevel() {
+		AdaptiveLevel adaptive;
+		adaptive.SetLevelCount(1);
+		CHECK(RunUntilChange(adaptive, SLOW_MS, 2000) == 2000);
+		CHECK(adaptive.GetLevel() == 0);
+	}
+}
+
+int main() {
+	StepsDownWhenSlow();
+	StaysWithinBudget();
+	IgnoresHitches();
+	StepsUpAfterDelay();
+	BacksOffAfterFailedStepUp();
+	SingleLevel();
+	return 0;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// stays on in release builds, unlike assert
+#define CHECK(condition) do { \
+	if (!(condition)) { \
+		std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+		std::exit(1); \
+	} \
+} while(0)
@@ -0,0 +1,52 @@
+#include <cstdint>
+#include <string>
+
+#include "Check.h"
+#include "util/InputLog.h"
+
+// the server decodes and checks the bytes written here, Task3ControllerTests uses the same log.
+// a change to the encoding has to change both
+namespace {
+	constexpr uint32_t HZ = InputLog::STEP_HZ;
+	constexpr uint32_t WIN_STEPS = 42 * HZ + 25;
+	constexpr const char* WIN_LOG = "SUwBPICAgPgD8hPxE60JAU4YAJ4uFwCdFwEBgAQBtAEA";
+
+	// recorded the way GameScene does it: the frame is pushed, then its step runs and
+	// the win in that step is at the step count
+	InputLog RecordWin() {
+		InputLog log;
+		for (uint32_t step = 0; step < WIN_STEPS; step++) {
+			if (step == 3 * HZ) log.PushEvent(InputEvent::DoorOpened);
+			InputFrame frame;
+			if (step < 30 * HZ) frame.keys = InputFrame::FORWARD;
+			if (step >= 5 * HZ && step < 5 * HZ + 20) frame.lookX = 12;
+			if (step == WIN_STEPS - 1) frame.keys = InputFrame::INTERACT;
+			log.Push(frame);
+		}
+		log.SetWinStep(log.GetStepCount());
+		return log;
+	}
+
+	void EncodesWin() {
+		const InputLog log = RecordWin();
+		CHECK(log.GetWinSeconds() == 42);
+		CHECK(log.EncodeBase64() == WIN_LOG);
+	}
+
+	void DecodesWin() {
+		const auto log = InputLog::DecodeBase64(WIN_LOG);
+		CHECK(log.has_value());
+		CHECK(log->GetStepCount() == WIN_STEPS);
+		CHECK(log->GetWinStep() == WIN_STEPS);
+		CHECK(log->GetEvents().size() == 1);
+		CHECK(log->GetEvents()[0].step == 3 * HZ);
+		CHECK(log->GetFrame(5 * HZ).lookX == 12);
+		CHECK(log->GetFrame(WIN_STEPS - 1).IsHeld(InputFrame::INTERACT));
+	}
+}
+
+int main() {
+	EncodesWin();
+	DecodesWin();
+	return 0;
+}
@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Check.h"
+#include "util/MemoryStats.h"
+
+namespace {
+	void AllocateAndFree() {
+		const auto before = MemoryStats::GetTagStats(MemoryTag::Meshes);
+		void* ptr = nullptr;
+		{
+			MemoryTagScope scope(MemoryTag::Meshes);
+			ptr = MemoryStats::Allocate(1000, 16);
+		}
+		CHECK(ptr);
+		const auto allocated = MemoryStats::GetTagStats(MemoryTag::Meshes);
+		CHECK(allocated.currentBytes == before.currentBytes + 1000);
+		CHECK(allocated.totalAllocations == before.totalAllocations + 1);
+		CHECK(allocated.peakBytes >= allocated.currentBytes);
+
+		MemoryStats::Free(ptr);
+		const auto freed = MemoryStats::GetTagStats(MemoryTag::Meshes);
+		CHECK(freed.currentBytes == before.currentBytes);
+		CHECK(freed.peakBytes == allocated.peakBytes);
+	}
+
+	void Alignment() {
+		for (const size_t alignment : {8, 16, 64, 256, 4096}) {
+			void* ptr = MemoryStats::Allocate(3, alignment);
+			CHECK(reinterpret_cast<uintptr_t>(ptr) % alignment == 0);
+			MemoryStats::Free(ptr);
+		}
+	}
+
+	// the tag is taken when the block is allocated, not when it is freed
+	void FreedUnderOtherTag() {
+		const auto before = MemoryStats::GetTagStats(MemoryTag::Text);
+		void* ptr = nullptr;
+		{
+			MemoryTagScope scope(MemoryTag::Text);
+			ptr = MemoryStats::Allocate(64, 8);
+			MemoryTagScope inner(MemoryTag::Physics);
+			CHECK(MemoryStats::GetCurrentTag() == MemoryTag::Physics);
+		}
+		CHECK(MemoryStats::GetCurrentTag() == MemoryTag::Other);
+		{
+			MemoryTagScope scope(MemoryTag::Scripts);
+			MemoryStats::Free(ptr);
+		}
+		CHECK(MemoryStats::GetTagStats(MemoryTag::Text).currentBytes == before.currentBytes);
+	}
+
+	// metrics builds replace global new/delete
+	void GlobalNew() {
+		const auto before = MemoryStats::GetTagStats(MemoryTag::Ecs);
+		std::vector<uint32_t>* values = nullptr;
+		{
+			MemoryTagScope scope(MemoryTag::Ecs);
+			values = new std::vector<uint32_t>(256);
+		}
+		const auto allocated = MemoryStats::GetTagStats(MemoryTag::Ecs);
+		CHECK(allocated.totalAllocations == before.totalAllocations + 2);
+		CHECK(allocated.currentBytes == before.currentBytes + sizeof(std::vector<uint32_t>) + 256 * sizeof(uint32_t));
+
+		delete values;
+		CHECK(MemoryStats::GetTagStats(MemoryTag::Ecs).currentBytes == before.currentBytes);
+
+		struct alignas(128) Aligned {
+			uint8_t data[128];
+		};
+		const auto aligned = std::make_unique<Aligned>();
+		CHECK(reinterpret_cast<uintptr_t>(aligned.get()) % 128 == 0);
+	}
+
+	void FrameCounters() {
+		MemoryStats::EndFrame();
+		{
+			MemoryTagScope scope(MemoryTag::Scripts);
+			for (int i = 0; i < 3; i++) MemoryStats::Free(MemoryStats::Allocate(100, 16));
+		}
+		MemoryStats::EndFrame();
+		const auto stats = MemoryStats::GetTagStats(MemoryTag::Scripts);
+		CHECK(stats.allocationsLastFrame == 3);
+		CHECK(stats.bytesLastFrame == 300);
+		CHECK(stats.currentBytes == 0);
+
+		MemoryStats::EndFrame();
+		CHECK(MemoryStats::GetTagStats(MemoryTag::Scripts).allocationsLastFrame == 0);
+	}
+}
+
+int main() {
+	AllocateAndFree();
+	Alignment();
+	FreedUnderOtherTag();
+	GlobalNew();
+	FrameCounters();
+	return 0;
+}
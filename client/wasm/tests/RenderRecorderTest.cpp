@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <string>
+
+#include "Check.h"
+#include "util/RenderRecorder.h"
+
+namespace {
+	using RenderRecorder::Call;
+
+	constexpr uint32_t GL_TRIANGLES = 0x0004;
+	constexpr uint32_t GL_TRIANGLE_STRIP = 0x0005;
+	constexpr uint32_t GL_LINES = 0x0001;
+	constexpr uint32_t GL_ARRAY_BUFFER = 0x8892;
+	constexpr uint32_t GL_ELEMENT_ARRAY_BUFFER = 0x8893;
+
+	uint32_t Calls(Call call) {
+		return RenderRecorder::GetFrameStats().calls[static_cast<size_t>(call)];
+	}
+	uint32_t Redundant(Call call) {
+		return RenderRecorder::GetFrameStats().redundant[static_cast<size_t>(call)];
+	}
+
+	// two meshes drawn twice each, the second draw of a mesh rebinds what is bound
+	void RecordFrame() {
+		RenderRecorder::RecordBind(Call::BindFramebuffer, 0, 0);
+		RenderRecorder::RecordBind(Call::UseProgram, 0, 3);
+		for (const uint32_t vao : {1, 1, 2, 2}) {
+			RenderRecorder::RecordBind(Call::BindVertexArray, 0, vao);
+			RenderRecorder::RecordUniform();
+			RenderRecorder::RecordDraw(GL_TRIANGLES, 300, 1);
+		}
+		RenderRecorder::RecordBind(Call::UseProgram, 0, 3);
+		RenderRecorder::RecordDraw(GL_TRIANGLE_STRIP, 4, 10);
+		RenderRecorder::RecordDraw(GL_LINES, 100, 1);
+	}
+
+	void CountsFrame() {
+		RenderRecorder::SetEnabled(true);
+		RecordFrame();
+		RenderRecorder::EndFrame();
+
+		CHECK(Calls(Call::Draw) == 6);
+		CHECK(RenderRecorder::GetFrameStats().triangles == 4 * 100 + 2 * 10);
+		CHECK(Calls(Call::BindVertexArray) == 4);
+		CHECK(Redundant(Call::BindVertexArray) == 2);
+		CHECK(Calls(Call::UseProgram) == 2);
+		CHECK(Redundant(Call::UseProgram) == 1);
+		CHECK(Calls(Call::Uniform) == 4);
+
+		// gl state carries over, the next frame starts with program 3 and vao 2 bound
+		RecordFrame();
+		RenderRecorder::EndFrame();
+		CHECK(Redundant(Call::UseProgram) == 2);
+		CHECK(Redundant(Call::BindVertexArray) == 2);
+		CHECK(Redundant(Call::BindFramebuffer) == 1);
+	}
+
+	// buffer targets are separate binding points
+	void BindingPoints() {
+		RenderRecorder::SetEnabled(true);
+		RenderRecorder::RecordBind(Call::BindBuffer, GL_ARRAY_BUFFER, 5);
+		RenderRecorder::RecordBind(Call::BindBuffer, GL_ELEMENT_ARRAY_BUFFER, 5);
+		RenderRecorder::RecordBind(Call::BindBuffer, GL_ARRAY_BUFFER, 5);
+		RenderRecorder::RecordBind(Call::BindBuffer, GL_ARRAY_BUFFER, 0);
+		RenderRecorder::RecordUpload(1024);
+		RenderRecorder::RecordUpload(76);
+		RenderRecorder::EndFrame();
+		CHECK(Calls(Call::BindBuffer) == 4);
+		CHECK(Redundant(Call::BindBuffer) == 1);
+		CHECK(Calls(Call::Upload) == 2);
+		CHECK(RenderRecorder::GetFrameStats().uploadBytes == 1100);
+	}
+
+	void Disabled() {
+		RenderRecorder::SetEnabled(false);
+		RecordFrame();
+		RenderRecorder::EndFrame();
+		CHECK(Calls(Call::Draw) == 0);
+		CHECK(RenderRecorder::GetFrameStats().triangles == 0);
+
+		// nothing is known to be bound after recording was off
+		RenderRecorder::SetEnabled(true);
+		RenderRecorder::RecordBind(Call::UseProgram, 0, 3);
+		RenderRecorder::EndFrame();
+		CHECK(Redundant(Call::UseProgram) == 0);
+	}
+
+	void Summary() {
+		RenderRecorder::SetEnabled(false);
+		RenderRecorder::SetEnabled(true);
+		RecordFrame();
+		RenderRecorder::RecordUpload(64);
+		RenderRecorder::EndFrame();
+		const std::string expected =
+			"frame draws=6 triangles=420 uploadBytes=64\n"
+			"draw calls=6 redundant=0\n"
+			"useProgram calls=2 redundant=1\n"
+			"bindVertexArray calls=4 redundant=2\n"
+			"bindBuffer calls=0 redundant=0\n"
+			"bindTexture calls=0 redundant=0\n"
+			"bindFramebuffer calls=1 redundant=0\n"
+			"uniform calls=4 redundant=0\n"
+			"upload calls=1 redundant=0\n";
+		CHECK(RenderRecorder::Summarize() == expected);
+	}
+}
+
+int main() {
+	CountsFrame();
+	BindingPoints();
+	Disabled();
+	Summary();
+	return 0;
+}
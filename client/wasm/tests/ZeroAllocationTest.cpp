@@ -0,0 +1,78 @@
+#include <cstdint>
+#include <string>
+
+#include "Check.h"
+#include "util/AdaptiveLevel.h"
+#include "util/AllocTracker.h"
+#include "util/Histogram.h"
+#include "util/InputLog.h"
+#include "util/MemoryStats.h"
+
+// once a run is going, the per frame work must not allocate. only the engine independent
+// part of a frame is covered here: the input log, the frame time histogram and adaptive
+// quality. the GameScene step (physics, scripts, ecs) needs the engine and is not, in a
+// debug browser build getAllocationReport() lists the sites that allocate every frame there
+namespace {
+	constexpr uint32_t SETTLE_FRAMES = 10;
+	constexpr uint32_t FRAMES = 600;
+
+	int* s_held = nullptr;
+
+	struct FrameState {
+		InputLog log;
+		LogHistogram frameTimes;
+		AdaptiveLevel adaptive;
+	};
+
+	void Tick(FrameState& state, uint32_t frame) {
+		InputFrame input;
+		input.keys = frame % 3 ? InputFrame::FORWARD : 0;
+		input.lookX = static_cast<int16_t>(frame % 7);
+		state.log.Push(input);
+		const float ms = 16.0f + static_cast<float>(frame % 5);
+		state.frameTimes.Add(ms);
+		state.adaptive.AddFrame(ms);
+		MemoryStats::EndFrame();
+	}
+
+	void EngineIndependentSteadyState() {
+		FrameState state;
+		state.adaptive.SetLevelCount(4);
+		// a restart keeps the capacity the previous run grew
+		for (uint32_t i = 0; i < FRAMES * 2; i++) Tick(state, i);
+		state.log.Clear();
+
+		AllocTracker::Reset(SETTLE_FRAMES);
+		for (uint32_t i = 0; i < SETTLE_FRAMES + FRAMES; i++) {
+			Tick(state, i);
+			if (AllocTracker::IsSettled()) CHECK(AllocTracker::GetFrameAllocations() == 0);
+		}
+		const AllocTracker::Site* sites[1];
+		CHECK(AllocTracker::GetSteadySites(sites, 1) == 0);
+	}
+
+	// the budget is only worth something if an allocating frame fails it
+	void DetectsAllocatingSite() {
+		FrameState state;
+		AllocTracker::Reset(SETTLE_FRAMES);
+		for (uint32_t i = 0; i < SETTLE_FRAMES + FRAMES; i++) {
+			delete[] s_held;
+			s_held = new int[16];
+			Tick(state, i);
+		}
+		delete[] s_held;
+		s_held = nullptr;
+
+		CHECK(AllocTracker::GetFrameAllocations() >= 1);
+		const AllocTracker::Site* sites[1];
+		CHECK(AllocTracker::GetSteadySites(sites, 1) == 1);
+		CHECK(AllocTracker::GetAllocationsPerFrame(*sites[0]) >= 1.0f);
+		CHECK(AllocTracker::GetReportJson().find("\"sites\":[{") != std::string::npos);
+	}
+}
+
+int main() {
+	EngineIndependentSteadyState();
+	DetectsAllocatingSite();
+	return 0;
+}
@@ -2,6 +2,7 @@ using System;
 using System.Collections.Generic;
 using System.Linq;
 using System.Security.Claims;
+using System.Text.Json;
 using System.Threading;
 using System.Threading.Tasks;
 using Microsoft.AspNetCore.Http;
@@ -16,6 +17,7 @@ using Microsoft.EntityFrameworkCore;
 using Microsoft.Extensions.Configuration;
 using Microsoft.Extensions.DependencyInjection;
 using server.src.Task3;
+using server.Exceptions;
 namespace server.Tests {
     public class Task3ControllerTests : IDisposable {
         private readonly Task3Controller _controller;
@@ -58,6 +60,37 @@ namespace server.Tests {
                 HttpContext = new DefaultHttpContext { User = user }
             };
         }
+        // log in the game's format: idle steps, the door opening at doorStep and the win at the last step
+        private static string EncodeLog(uint steps, bool win, uint? doorStep) {
+            var bytes = new List<byte> { (byte)'I', (byte)'L' };
+            void Varint(uint value) {
+                while (value >= 0x80) {
+                    bytes.Add((byte)(value | 0x80));
+                    value >>= 7;
+                }
+                bytes.Add((byte)value);
+            }
+            Varint(Task3InputLog.Version);
+            Varint(Task3InputLog.StepHz);
+            Varint(BitConverter.SingleToUInt32Bits(0.5f));
+            Varint(win ? steps + 1 : 0);
+            Varint(steps);
+            if (steps > 0) {
+                Varint((steps - 1) << 2);
+            }
+            Varint(doorStep == null ? 0u : 1u);
+            if (doorStep != null) {
+                Varint(doorStep.Value);
+                bytes.Add(0);
+            }
+            return Convert.ToBase64String(bytes.ToArray());
+        }
+        // written by the game's InputLog encoder, a 42 second win. client/wasm/tests/InputLogTest.cpp
+        // checks that the encoder still produces exactly these bytes
+        private const string GameWinLog = "SUwBPICAgPgD8hPxE60JAU4YAJ4uFwCdFwEBgAQBtAEA";
+        private static Task3TimeTakenRequest LogRequest(int seconds) {
+            return new Task3TimeTakenRequest { InputLog = EncodeLog((uint)seconds * Task3InputLog.StepHz, true, 600) };
+        }
         [Fact]
         public void PostGetTask_ReturnsDoorCodeTaskResponse()
         {
@@ -82,7 +115,7 @@ namespace server.Tests {
             // Arrange
             SetUserEmail(null);
 
-            var ans = _controller.PostSaveTask3TimeTaken(50);
+            var ans = _controller.PostSaveTask3TimeTaken(50, LogRequest(50));
             var notFoundResult = Assert.IsType<NotFoundObjectResult>(ans.Result);
             Assert.Equal("failure", notFoundResult.Value);
         }
@@ -92,10 +125,106 @@ namespace server.Tests {
             // Arrange
             SetUserEmail("test@example.com");
 
-            var ans = _controller.PostSaveTask3TimeTaken(50);
+            var ans = _controller.PostSaveTask3TimeTaken(50, LogRequest(50));
+            var OkResult = Assert.IsType<OkObjectResult>(ans.Result);
+            Assert.Equal("success", OkResult.Value);
+        }
+        [Fact]
+        public async Task PostSaveTask3TimeTaken_AcceptsGameLog()
+        {
+            SetUserEmail("test@example.com");
+            var log = Task3InputLog.Decode(GameWinLog);
+            Assert.NotNull(log);
+            Assert.Equal(log.StepCount, log.WinStep);
+
+            var ans = _controller.PostSaveTask3TimeTaken(42, new Task3TimeTakenRequest { InputLog = GameWinLog });
             var OkResult = Assert.IsType<OkObjectResult>(ans.Result);
             Assert.Equal("success", OkResult.Value);
         }
+        [Fact]
+        public async Task PostSaveTask3TimeTaken_RejectsFasterClaimThanLog()
+        {
+            SetUserEmail("test@example.com");
+
+            var ans = _controller.PostSaveTask3TimeTaken(10, LogRequest(50));
+            var badResult = Assert.IsType<BadRequestObjectResult>(ans.Result);
+            Assert.Equal("failure", badResult.Value);
+        }
+        [Fact]
+        public async Task PostSaveTask3TimeTaken_RejectsLogWithoutDoor()
+        {
+            SetUserEmail("test@example.com");
+            var request = new Task3TimeTakenRequest { InputLog = EncodeLog(50 * Task3InputLog.StepHz, true, null) };
+
+            var ans = _controller.PostSaveTask3TimeTaken(50, request);
+            Assert.IsType<BadRequestObjectResult>(ans.Result);
+        }
+        [Fact]
+        public async Task PostSaveTask3TimeTaken_RejectsMalformedLog()
+        {
+            SetUserEmail("test@example.com");
+
+            var missing = _controller.PostSaveTask3TimeTaken(50, new Task3TimeTakenRequest());
+            Assert.IsType<BadRequestObjectResult>(missing.Result);
+            var garbage = _controller.PostSaveTask3TimeTaken(50, new Task3TimeTakenRequest { InputLog = "SUwB" });
+            Assert.IsType<BadRequestObjectResult>(garbage.Result);
+            var notBase64 = _controller.PostSaveTask3TimeTaken(50, new Task3TimeTakenRequest { InputLog = "not a log!" });
+            Assert.IsType<BadRequestObjectResult>(notBase64.Result);
+        }
+        private const string TelemetryBatch = "{\"scene\":\"firstmap\",\"seconds\":60.0,\"hitches\":2,\"severeHitches\":0,"
+            + "\"fxaa\":1,\"shadows\":2,\"outlines\":1,\"qualityLevel\":0,\"timings\":{"
+            + "\"frame\":{\"count\":3600,\"mean\":16.7,\"p50\":16.6,\"p95\":17.1,\"p99\":33.3,\"max\":50.2},"
+            + "\"physics\":{\"count\":3600,\"mean\":1.2,\"p50\":1.1,\"p95\":2.0,\"p99\":2.5,\"max\":4.0}},"
+            + "\"gpu\":\"ANGLE\",\"userAgent\":\"Mozilla/5.0\",\"cores\":8,\"pixelRatio\":1.5,\"screen\":\"1920x1080\"}";
+        private IActionResult PostTelemetry(string json) {
+            return _controller.PostTask3Telemetry(JsonDocument.Parse(json).RootElement);
+        }
+        [Fact]
+        public void PostTask3Telemetry_AcceptsBatch()
+        {
+            SetUserEmail("test@example.com");
+
+            var ans = PostTelemetry(TelemetryBatch);
+            var OkResult = Assert.IsType<OkObjectResult>(ans);
+            Assert.Equal("success", OkResult.Value);
+        }
+        [Fact]
+        public void PostTask3Telemetry_RequiresUser()
+        {
+            SetUserEmail(null);
+
+            Assert.Throws<UnauthorizedException>(() => PostTelemetry(TelemetryBatch));
+        }
+        [Fact]
+        public void PostTask3Telemetry_RejectsNonObject()
+        {
+            SetUserEmail("test@example.com");
+
+            var ans = PostTelemetry("[1,2]");
+            var badResult = Assert.IsType<BadRequestObjectResult>(ans);
+            Assert.Equal("failure", badResult.Value);
+        }
+        [Fact]
+        public void PostTask3Telemetry_RejectsBadFields()
+        {
+            SetUserEmail("test@example.com");
+
+            Assert.IsType<BadRequestObjectResult>(PostTelemetry(TelemetryBatch.Replace("firstmap", "elsewhere")));
+            Assert.IsType<BadRequestObjectResult>(PostTelemetry(TelemetryBatch.Replace("\"hitches\":2", "\"hitches\":-2")));
+            Assert.IsType<BadRequestObjectResult>(PostTelemetry(TelemetryBatch.Replace("\"fxaa\":1", "\"fxaa\":\"1\"")));
+            Assert.IsType<BadRequestObjectResult>(PostTelemetry(TelemetryBatch.Replace("\"p95\":17.1", "\"p95\":{}")));
+            Assert.IsType<BadRequestObjectResult>(PostTelemetry(TelemetryBatch.Replace("\"cores\":8", "\"extra\":8")));
+            Assert.IsType<BadRequestObjectResult>(PostTelemetry("{\"timings\":{}}"));
+        }
+        [Fact]
+        public void PostTask3Telemetry_RejectsOversized()
+        {
+            SetUserEmail("test@example.com");
+            var userAgent = new string('a', Task3Telemetry.MaxBytes);
+
+            var ans = PostTelemetry(TelemetryBatch.Replace("Mozilla/5.0", userAgent));
+            Assert.IsType<BadRequestObjectResult>(ans);
+        }
             
         public void Dispose()
         {
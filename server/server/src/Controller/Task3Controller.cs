@@ -1,8 +1,11 @@
+using Microsoft.AspNetCore.Authorization;
 using Microsoft.AspNetCore.Mvc;
 using server.src;
 using server.UserNamespace;
 using System.Security.Claims;
+using System.Text.Json;
 using server.src.Task3;
+using server.Exceptions;
 
 namespace server.Controller {
     [Route("api")]
@@ -25,7 +28,16 @@ namespace server.Controller {
             return req.GetResponse<Task3BookHintResponse>();
         }
         [HttpPost("SaveTask3TimeTaken")]
-        public async Task<IActionResult> PostSaveTask3TimeTaken(int seconds) {
+        public async Task<IActionResult> PostSaveTask3TimeTaken(int seconds, [FromBody] Task3TimeTakenRequest req) {
+            // the uploaded input log has to be consistent with the claimed time. this is a sanity
+            // check, not anti-cheat: nothing re-simulates the log, a forged one passes
+            var inputLog = Task3InputLog.Decode(req.InputLog);
+            string? reason = inputLog == null ? "malformed input log" : inputLog.Check(seconds);
+            if (reason != null) {
+                System.Console.WriteLine("Rejected task3 time: " + reason);
+                return BadRequest("failure");
+            }
+
             // calculate score based on time taken
             int max = 2000;
             int min = 100;
@@ -45,5 +57,22 @@ namespace server.Controller {
             }
             return Ok("success");
         }
+        [Authorize]
+        [RequestSizeLimit(Task3Telemetry.MaxBytes)]
+        [HttpPost("Task3Telemetry")]
+        public IActionResult PostTask3Telemetry([FromBody] JsonElement telemetry) {
+            var userEmail = User.FindFirst(ClaimTypes.Email)?.Value;
+            if (string.IsNullOrEmpty(userEmail)) {
+                throw new UnauthorizedException("Invalid token.");
+            }
+            // frame pacing batches from the game, one line each for the log pipeline
+            string? reason = Task3Telemetry.Check(telemetry);
+            if (reason != null) {
+                System.Console.WriteLine("Rejected task3 telemetry: " + reason);
+                return BadRequest("failure");
+            }
+            System.Console.WriteLine("Task3 telemetry: " + telemetry.GetRawText());
+            return Ok("success");
+        }
     }
 }
\ No newline at end of file
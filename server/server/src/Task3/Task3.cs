@@ -64,4 +64,12 @@ namespace server.src.Task3 {
             Hints = new string[0];
         }
     }
+    public class Task3TimeTakenRequest {
+        // base64 input log of the run, see Task3InputLog
+        public string InputLog { get; set; }
+
+        public Task3TimeTakenRequest() {
+            InputLog = "";
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,205 @@
+namespace server.src.Task3 {
+    // input log uploaded with a task 3 time, in the format of the game's InputLog.cpp.
+    // the server can not re-simulate the game's physics, so Check does not prove a run.
+    // it rejects logs that can not be a win in the claimed time: wrong step count,
+    // no secret door, impossible input.
+    public class Task3InputLog {
+        public const uint Version = 1;
+        public const uint StepHz = 60;
+        // a decoder must not allocate whatever a hostile header asks for, ~5 hours of play
+        public const uint MaxSteps = StepHz * 60 * 60 * 5;
+
+        // whole pixels per step, the client clamps each frame to 1000 and a step can collect a few frames
+        private const int MaxLookPerStep = 8000;
+        private const int KnownKeys = (1 << 10) - 1;
+        // the game asks the server for the door code at most once a second
+        private const uint MinDoorCheckSteps = StepHz;
+
+        private const byte DoorOpenedEvent = 0;
+        private const byte EventCount = 1;
+        // tag bits of a step record, the rest of the tag is the repeat count
+        private const uint KeysChanged = 1 << 0;
+        private const uint LookChanged = 1 << 1;
+        private const int TagBits = 2;
+
+        public struct Frame {
+            public ushort Keys;
+            public short LookX;
+            public short LookY;
+        }
+        // identical steps stay collapsed, a long idle log is a few runs
+        public struct Run {
+            public Frame Frame;
+            public uint Count;
+        }
+        public struct Event {
+            public uint Step;
+            public byte Type;
+        }
+
+        public List<Run> Runs { get; } = new List<Run>();
+        public List<Event> Events { get; } = new List<Event>();
+        public uint StepCount { get; private set; }
+        // null when the log ends without a win
+        public uint? WinStep { get; private set; }
+
+        // null for anything that is not a log the game wrote
+        public static Task3InputLog? Decode(string? base64) {
+            if (string.IsNullOrEmpty(base64)) {
+                return null;
+            }
+            byte[] data;
+            try {
+                data = Convert.FromBase64String(base64);
+            }
+            catch (FormatException) {
+                return null;
+            }
+
+            var reader = new Reader(data);
+            if (!reader.Byte(out byte m0) || !reader.Byte(out byte m1) || m0 != 'I' || m1 != 'L') {
+                return null;
+            }
+            if (!reader.Varint(out uint version) || version != Version) {
+                return null;
+            }
+            if (!reader.Varint(out uint stepHz) || stepHz != StepHz) {
+                return null;
+            }
+            if (!reader.Varint(out _) || !reader.Varint(out uint winStep) || !reader.Varint(out uint stepCount)) {
+                return null;
+            }
+            if (stepCount > MaxSteps) {
+                return null;
+            }
+
+            var log = new Task3InputLog();
+            if (winStep != 0) {
+                if (winStep - 1 > stepCount) {
+                    return null;
+                }
+                log.WinStep = winStep - 1;
+            }
+
+            var frame = new Frame();
+            while (log.StepCount < stepCount) {
+                if (!reader.Varint(out uint tag)) {
+                    return null;
+                }
+                if ((tag & KeysChanged) != 0) {
+                    if (!reader.Varint(out uint keys) || keys > 0xffff) {
+                        return null;
+                    }
+                    frame.Keys ^= (ushort)keys;
+                }
+                if ((tag & LookChanged) != 0) {
+                    if (!reader.Varint(out uint dx) || !reader.Varint(out uint dy)) {
+                        return null;
+                    }
+                    frame.LookX = unchecked((short)(frame.LookX + UnZigZag(dx)));
+                    frame.LookY = unchecked((short)(frame.LookY + UnZigZag(dy)));
+                }
+                uint count = (tag >> TagBits) + 1;
+                if (count > stepCount - log.StepCount) {
+                    return null;
+                }
+                log.Runs.Add(new Run { Frame = frame, Count = count });
+                log.StepCount += count;
+            }
+
+            if (!reader.Varint(out uint eventCount) || eventCount > stepCount + 1) {
+                return null;
+            }
+            uint step = 0;
+            for (uint i = 0; i < eventCount; i++) {
+                if (!reader.Varint(out uint delta) || !reader.Byte(out byte type) || type >= EventCount) {
+                    return null;
+                }
+                if (delta > stepCount - step) {
+                    return null;
+                }
+                step += delta;
+                log.Events.Add(new Event { Step = step, Type = type });
+            }
+            return reader.AtEnd ? log : null;
+        }
+
+        // null when the log is consistent with a win in claimedSeconds, the reason otherwise
+        public string? Check(int claimedSeconds) {
+            if (WinStep == null) {
+                return "no win in log";
+            }
+            if (WinStep != StepCount) {
+                return "log does not end at the win";
+            }
+            if (claimedSeconds < 0 || WinStep / StepHz != (uint)claimedSeconds) {
+                return "claimed time does not match the steps";
+            }
+
+            foreach (var run in Runs) {
+                if ((run.Frame.Keys & ~KnownKeys) != 0) {
+                    return "unknown keys";
+                }
+                if (Math.Abs((int)run.Frame.LookX) > MaxLookPerStep || Math.Abs((int)run.Frame.LookY) > MaxLookPerStep) {
+                    return "look out of range";
+                }
+            }
+
+            uint? doorOpened = null;
+            foreach (var e in Events) {
+                if (e.Type != DoorOpenedEvent) {
+                    continue;
+                }
+                if (doorOpened != null) {
+                    return "door opened twice";
+                }
+                doorOpened = e.Step;
+            }
+            // the golden book is behind the secret door, and the code takes a second to check
+            if (doorOpened == null) {
+                return "door never opened";
+            }
+            if (doorOpened < MinDoorCheckSteps) {
+                return "door opened before the code could be checked";
+            }
+            return null;
+        }
+
+        private static int UnZigZag(uint value) {
+            return (int)(value >> 1) ^ -(int)(value & 1);
+        }
+
+        private class Reader {
+            private readonly byte[] _data;
+            private int _pos;
+
+            public Reader(byte[] data) {
+                _data = data;
+            }
+
+            public bool AtEnd => _pos == _data.Length;
+
+            public bool Byte(out byte value) {
+                value = 0;
+                if (_pos >= _data.Length) {
+                    return false;
+                }
+                value = _data[_pos++];
+                return true;
+            }
+            public bool Varint(out uint value) {
+                value = 0;
+                for (int shift = 0; shift < 35; shift += 7) {
+                    if (!Byte(out byte b)) {
+                        return false;
+                    }
+                    value |= (uint)(b & 0x7f) << shift;
+                    if ((b & 0x80) == 0) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+        }
+    }
+}
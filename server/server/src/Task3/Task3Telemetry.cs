@@ -0,0 +1,84 @@
+using System.Text.Json;
+
+namespace server.src.Task3 {
+    // frame pacing batch posted by the game, in the format of the game's Telemetry.cpp
+    // plus the browser fields the page adds. batches are only logged, Check keeps
+    // anything that is not such a batch out of the log.
+    public static class Task3Telemetry {
+        // a full batch is well under 2 KiB
+        public const int MaxBytes = 8 * 1024;
+
+        private static readonly string[] Scenes = { "firstmap", "world1", "test" };
+        private static readonly string[] Timings = { "frame", "update", "physics", "scripts" };
+        private static readonly string[] Stats = { "count", "mean", "p50", "p95", "p99", "max" };
+        private const int MaxTextLength = 512;
+        // a batch is sent at least once a minute and on every level switch
+        private const double MaxSeconds = 600;
+        private const double MaxMs = 60 * 1000;
+
+        // null when the batch is valid, the reason otherwise
+        public static string? Check(JsonElement batch) {
+            if (batch.ValueKind != JsonValueKind.Object) {
+                return "not an object";
+            }
+            if (batch.GetRawText().Length > MaxBytes) {
+                return "too large";
+            }
+
+            foreach (var field in batch.EnumerateObject()) {
+                var value = field.Value;
+                bool valid = field.Name switch {
+                    "scene" => value.ValueKind == JsonValueKind.String && Array.IndexOf(Scenes, value.GetString()) >= 0,
+                    "seconds" => IsNumber(value, 0, MaxSeconds),
+                    "hitches" or "severeHitches" => IsInteger(value, 0, int.MaxValue),
+                    "fxaa" or "shadows" or "outlines" => IsInteger(value, 0, 3),
+                    "qualityLevel" => IsInteger(value, 0, 15),
+                    "timings" => CheckTimings(value),
+                    "gpu" or "userAgent" or "screen" => IsText(value),
+                    "cores" or "memory" => IsNumber(value, 0, 1024),
+                    "pixelRatio" => IsNumber(value, 0, 16),
+                    _ => false,
+                };
+                if (!valid) {
+                    return "bad field " + field.Name;
+                }
+            }
+            if (!batch.TryGetProperty("scene", out _) || !batch.TryGetProperty("timings", out _)) {
+                return "missing scene or timings";
+            }
+            return null;
+        }
+
+        private static bool CheckTimings(JsonElement timings) {
+            if (timings.ValueKind != JsonValueKind.Object) {
+                return false;
+            }
+            foreach (var timing in timings.EnumerateObject()) {
+                if (Array.IndexOf(Timings, timing.Name) < 0 || timing.Value.ValueKind != JsonValueKind.Object) {
+                    return false;
+                }
+                foreach (var stat in timing.Value.EnumerateObject()) {
+                    if (Array.IndexOf(Stats, stat.Name) < 0) {
+                        return false;
+                    }
+                    bool valid = stat.Name == "count" ? IsInteger(stat.Value, 0, int.MaxValue) : IsNumber(stat.Value, 0, MaxMs);
+                    if (!valid) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+        private static bool IsNumber(JsonElement value, double min, double max) {
+            return value.ValueKind == JsonValueKind.Number && value.TryGetDouble(out double number)
+                && number >= min && number <= max;
+        }
+        private static bool IsInteger(JsonElement value, long min, long max) {
+            return value.ValueKind == JsonValueKind.Number && value.TryGetInt64(out long number)
+                && number >= min && number <= max;
+        }
+        private static bool IsText(JsonElement value) {
+            return value.ValueKind == JsonValueKind.String && value.GetString()!.Length <= MaxTextLength;
+        }
+    }
+}